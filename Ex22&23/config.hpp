@@ -66,6 +66,14 @@ namespace config
      */
     constexpr size_t NB_REMPLISSAGES = 3;
 
+    /**
+     * NB_ATTRIBUTS / NB_VALEURS: 卡牌编号的维度
+     * 每张卡牌可看作 4 位三进制数（每个特征一位），编号范围 0..80
+     * 即 NB_CARTES = NB_VALEURS ^ NB_ATTRIBUTS
+     */
+    constexpr size_t NB_ATTRIBUTS = 4;
+    constexpr size_t NB_VALEURS = 3;
+
     // ========================================================================
     // 游戏规则配置 (Game Rules Configuration)
     // ========================================================================
@@ -77,16 +85,20 @@ namespace config
     constexpr size_t PLATEAU_MIN_CARTES = 12;
 
     /**
-     * PLATEAU_INITIAL_CAPACITY: Plateau 动态数组的初始容量
-     * 避免频繁扩容，提高性能
+     * TAILLE_MAX_SANS_SET: 最大的无 SET 卡牌集合（cap set）的大小
+     * 由 outils/capset 穷举验证（并统计出所有这样的集合）
      */
-    constexpr size_t PLATEAU_INITIAL_CAPACITY = 5;
+    constexpr size_t TAILLE_MAX_SANS_SET = 20;
 
     /**
-     * PLATEAU_INCREMENT: Plateau 扩容时每次增加的容量
-     * 当数组满时，以此值为增量进行扩容
+     * PLATEAU_MAX_CARTES: Plateau 的固定容量（21 张）
+     *
+     * 最大的无 SET 卡牌集合有 TAILLE_MAX_SANS_SET 张，所以再加一张牌一定会构成 SET。
+     * 这个上限依赖调用者的义务：桌面满 12 张后，只有在桌面上没有 SET 时才调用
+     * Controleur::distribuer() 加牌（simulation.cpp 和 outils 中的对局循环都是这样做的）。
+     * distribuer() 本身并不检查 SET：它总会至少抽一张牌，桌面超出容量时抛出 SetException
      */
-    constexpr size_t PLATEAU_INCREMENT = 5;
+    constexpr size_t PLATEAU_MAX_CARTES = TAILLE_MAX_SANS_SET + 1;
 
     // ========================================================================
     // 显示配置 (Display Configuration)
@@ -97,6 +109,32 @@ namespace config
      * 用于格式化输出，让显示更整齐
      */
     constexpr size_t PLATEAU_CARTES_PER_LINE = 3;
+
+    // ========================================================================
+    // 边界检查策略 (Bounds Checking Policy)
+    // ========================================================================
+
+    /**
+     * Verification: Jeu、Pioche、Plateau 及其迭代器的访问器如何检查参数
+     * - verifiee:  越界时抛出 SetException（默认，与原来的行为相同）
+     * - assertion: 只做 assert()，定义 NDEBUG 后完全消失（调试构建用）
+     * - aucune:    不检查，访问器编译成一次普通的下标读取（发布构建用）
+     *
+     * 编译时用宏选择：-DSET_VERIFICATION=0 / 1 / 2
+     * 不想要异常的调用者在任何策略下都可以使用 essayer* 系列接口（返回 CodeErreur）
+     */
+    enum class Verification
+    {
+        verifiee,
+        assertion,
+        aucune
+    };
+
+#ifndef SET_VERIFICATION
+#define SET_VERIFICATION 0
+#endif
+    static_assert(SET_VERIFICATION >= 0 && SET_VERIFICATION <= 2, "SET_VERIFICATION doit valoir 0, 1 ou 2");
+    constexpr Verification VERIFICATION = Verification(SET_VERIFICATION);
 }
 
 #endif // SET_CONFIG_H
\ No newline at end of file
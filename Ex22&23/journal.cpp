@@ -0,0 +1,364 @@
+/**
+ * ============================================================================
+ * 二进制对局日志实现文件 (Binary Game Replay Log Implementation)
+ * ============================================================================
+ */
+
+#include "journal.h"
+#include <chrono>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Set
+{
+	namespace
+	{
+		const char MAGIE[4] = {'S', 'E', 'T', 'J'};
+		constexpr size_t TAILLE_ENTETE = 8;
+
+		constexpr std::uint8_t CODE_AJOUTER = config::NB_CARTES;
+		constexpr std::uint8_t CODE_RETIRER = 2 * config::NB_CARTES;
+		constexpr std::uint8_t CODE_RECLAMER = 3 * config::NB_CARTES;
+		constexpr std::uint8_t CODE_DEBUT = CODE_RECLAMER + 1;
+		constexpr std::uint8_t CODE_RESTAURER = CODE_RECLAMER + 2;
+		constexpr std::uint8_t CODE_FIN = CODE_RECLAMER + 3;
+		constexpr size_t TAILLE_ETAT = 32;
+
+		std::uint64_t lireMot(const std::uint8_t *p)
+		{
+			std::uint64_t x = 0;
+			for (size_t i = 0; i < 8; i++)
+				x |= std::uint64_t(p[i]) << (8 * i);
+			return x;
+		}
+	}
+
+	// ========================================================================
+	// Journal
+	// ========================================================================
+
+	Journal::Journal(std::ostream &f) : sortie(f)
+	{
+		tampon.reserve(TAILLE_TAMPON + 64);
+		tampon.insert(tampon.end(), MAGIE, MAGIE + 4);
+		tampon.push_back(VERSION);
+		tampon.insert(tampon.end(), 3, 0);
+	}
+
+	Journal::~Journal()
+	{
+		vider();
+	}
+
+	void Journal::vider()
+	{
+		sortie.write(reinterpret_cast<const char *>(tampon.data()), std::streamsize(tampon.size()));
+		tampon.clear();
+	}
+
+	void Journal::ecrireEtat(std::uint8_t code, const MasqueCartes &plateau, const MasqueCartes &pioche)
+	{
+		tampon.push_back(code);
+		for (std::uint64_t mot : {plateau.mots[0], plateau.mots[1], pioche.mots[0], pioche.mots[1]})
+			for (size_t i = 0; i < 8; i++)
+				tampon.push_back(std::uint8_t(mot >> (8 * i)));
+		verifierTampon();
+	}
+
+	void Journal::debutPartie(const EtatJeu &e)
+	{
+		ecrireEtat(CODE_DEBUT, e.plateau, e.getMasquePioche());
+	}
+
+	void Journal::restaurer(const EtatJeu &e)
+	{
+		ecrireEtat(CODE_RESTAURER, e.plateau, e.getMasquePioche());
+	}
+
+	void Journal::finPartie()
+	{
+		tampon.push_back(CODE_FIN);
+		verifierTampon();
+	}
+
+	void Journal::piocher(CarteId id)
+	{
+		tampon.push_back(id);
+		verifierTampon();
+	}
+
+	void Journal::ajouter(CarteId id)
+	{
+		tampon.push_back(std::uint8_t(CODE_AJOUTER + id));
+		verifierTampon();
+	}
+
+	void Journal::retirer(CarteId id)
+	{
+		tampon.push_back(std::uint8_t(CODE_RETIRER + id));
+		verifierTampon();
+	}
+
+	void Journal::reclamer(const Triplet &t)
+	{
+		tampon.push_back(CODE_RECLAMER);
+		tampon.push_back(t.a);
+		tampon.push_back(t.b);
+		tampon.push_back(t.c);
+		verifierTampon();
+	}
+
+	// ========================================================================
+	// LecteurJournal
+	// ========================================================================
+
+	LecteurJournal::LecteurJournal(const std::string &chemin)
+	{
+		int fd = ::open(chemin.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw SetException("LecteurJournal : impossible d'ouvrir " + chemin);
+		struct stat infos;
+		if (::fstat(fd, &infos) != 0)
+		{
+			::close(fd);
+			throw SetException("LecteurJournal : fstat a echoue");
+		}
+		taille = size_t(infos.st_size);
+		if (taille < TAILLE_ENTETE)
+		{
+			::close(fd);
+			throw SetException("LecteurJournal : fichier trop court");
+		}
+		void *p = ::mmap(nullptr, taille, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd); // le mapping reste valide apres close
+		if (p == MAP_FAILED)
+			throw SetException("LecteurJournal : mmap a echoue");
+		debut = static_cast<const std::uint8_t *>(p);
+		// 顺序读取：提示内核提前预读
+		::madvise(p, taille, MADV_SEQUENTIAL);
+
+		if (debut[0] != MAGIE[0] || debut[1] != MAGIE[1] || debut[2] != MAGIE[2] || debut[3] != MAGIE[3] ||
+			debut[4] != Journal::VERSION)
+		{
+			::munmap(p, taille);
+			throw SetException("LecteurJournal : en-tete invalide");
+		}
+		position = TAILLE_ENTETE;
+	}
+
+	LecteurJournal::~LecteurJournal()
+	{
+		::munmap(const_cast<std::uint8_t *>(debut), taille);
+	}
+
+	void LecteurJournal::rembobiner()
+	{
+		position = TAILLE_ENTETE;
+	}
+
+	bool LecteurJournal::suivant(Evenement &e)
+	{
+		if (position >= taille)
+			return false;
+		std::uint8_t code = debut[position];
+		if (code < CODE_RECLAMER)
+		{
+			e.type = TypeEvenement(code / config::NB_CARTES);
+			e.cartes[0] = CarteId(code % config::NB_CARTES);
+			position++;
+			return true;
+		}
+		switch (code)
+		{
+		case CODE_RECLAMER:
+			if (position + 4 > taille)
+				throw SetException("LecteurJournal : evenement tronque");
+			e.type = TypeEvenement::reclamer;
+			for (size_t i = 0; i < 3; i++)
+			{
+				e.cartes[i] = debut[position + 1 + i];
+				if (e.cartes[i] >= config::NB_CARTES)
+					throw SetException("LecteurJournal : carte inexistante");
+			}
+			position += 4;
+			return true;
+		case CODE_DEBUT:
+		case CODE_RESTAURER:
+		{
+			if (position + 1 + TAILLE_ETAT > taille)
+				throw SetException("LecteurJournal : evenement tronque");
+			const std::uint8_t *p = debut + position + 1;
+			e.type = code == CODE_DEBUT ? TypeEvenement::debut : TypeEvenement::restaurer;
+			e.plateau.mots[0] = lireMot(p);
+			e.plateau.mots[1] = lireMot(p + 8);
+			e.pioche.mots[0] = lireMot(p + 16);
+			e.pioche.mots[1] = lireMot(p + 24);
+			position += 1 + TAILLE_ETAT;
+			return true;
+		}
+		case CODE_FIN:
+			e.type = TypeEvenement::fin;
+			position++;
+			return true;
+		default:
+			throw SetException("LecteurJournal : type d'evenement inconnu");
+		}
+	}
+
+	RapportJournal LecteurJournal::verifier()
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		RapportJournal r;
+		r.nbOctets = taille;
+		rembobiner();
+
+		MasqueCartes plateau, pioche, tirees;
+		bool enCours = false;
+		Evenement e;
+		size_t positionEvenement = position;
+		auto erreur = [&](const char *message)
+		{
+			if (r.nbErreurs++ == 0)
+			{
+				r.positionPremiereErreur = positionEvenement;
+				r.premiereErreur = message;
+			}
+		};
+
+		while (true)
+		{
+			positionEvenement = position;
+			try
+			{
+				if (!suivant(e))
+					break;
+			}
+			catch (SetException &ex)
+			{
+				erreur("evenement illisible");
+				break;
+			}
+			r.nbEvenements++;
+
+			if (!enCours && e.type != TypeEvenement::debut)
+			{
+				erreur("evenement hors partie");
+				continue;
+			}
+			switch (e.type)
+			{
+			case TypeEvenement::debut:
+				if (enCours)
+					erreur("partie precedente non terminee");
+				enCours = true;
+				r.nbParties++;
+				plateau = e.plateau;
+				pioche = e.pioche;
+				tirees = MasqueCartes();
+				break;
+			case TypeEvenement::restaurer:
+				plateau = e.plateau;
+				pioche = e.pioche;
+				tirees = MasqueCartes();
+				break;
+			case TypeEvenement::piocher:
+				if (!pioche.contient(e.cartes[0]))
+					erreur("piocher : carte absente de la pioche");
+				pioche.retirer(e.cartes[0]);
+				tirees.ajouter(e.cartes[0]);
+				break;
+			case TypeEvenement::ajouter:
+				if (!tirees.contient(e.cartes[0]) || plateau.contient(e.cartes[0]))
+					erreur("ajouter : carte non piochee ou deja sur le plateau");
+				tirees.retirer(e.cartes[0]);
+				plateau.ajouter(e.cartes[0]);
+				break;
+			case TypeEvenement::retirer:
+				if (!plateau.contient(e.cartes[0]))
+					erreur("retirer : carte absente du plateau");
+				plateau.retirer(e.cartes[0]);
+				break;
+			case TypeEvenement::reclamer:
+				// estUnSet(x, x, x) est vrai : il faut aussi trois cartes distinctes
+				if (e.cartes[0] == e.cartes[1] || e.cartes[0] == e.cartes[2] || e.cartes[1] == e.cartes[2] ||
+					!plateau.contient(e.cartes[0]) || !plateau.contient(e.cartes[1]) || !plateau.contient(e.cartes[2]) ||
+					!estUnSet(e.cartes[0], e.cartes[1], e.cartes[2]))
+					erreur("reclamer : combinaison invalide");
+				r.nbSets++;
+				break;
+			case TypeEvenement::fin:
+				enCours = false;
+				break;
+			}
+		}
+		if (enCours)
+		{
+			positionEvenement = position;
+			erreur("derniere partie non terminee");
+		}
+		r.dureeSecondes = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		return r;
+	}
+
+	void LecteurJournal::convertirEnTexte(ostream &f)
+	{
+		rembobiner();
+		Jeu &jeu = Jeu::getInstance();
+		Evenement e;
+		size_t partie = 0;
+		while (suivant(e))
+		{
+			switch (e.type)
+			{
+			case TypeEvenement::debut:
+				f << "debut partie " << ++partie << " : plateau " << e.plateau.getNbCartes()
+				  << " cartes, pioche " << e.pioche.getNbCartes() << " cartes\n";
+				break;
+			case TypeEvenement::restaurer:
+				f << "restaurer : plateau " << e.plateau.getNbCartes()
+				  << " cartes, pioche " << e.pioche.getNbCartes() << " cartes\n";
+				break;
+			case TypeEvenement::piocher:
+				f << "piocher  " << jeu.getCarte(e.cartes[0]) << "\n";
+				break;
+			case TypeEvenement::ajouter:
+				f << "ajouter  " << jeu.getCarte(e.cartes[0]) << "\n";
+				break;
+			case TypeEvenement::retirer:
+				f << "retirer  " << jeu.getCarte(e.cartes[0]) << "\n";
+				break;
+			case TypeEvenement::reclamer:
+				f << "reclamer " << Combinaison(Triplet{e.cartes[0], e.cartes[1], e.cartes[2]}) << "\n";
+				break;
+			case TypeEvenement::fin:
+				f << "fin partie " << partie << "\n";
+				break;
+			}
+		}
+	}
+
+	void LecteurJournal::collecterSets(TamponCombinaisons &t)
+	{
+		rembobiner();
+		Evenement e;
+		while (suivant(e))
+			if (e.type == TypeEvenement::reclamer) // suivant() garantit des ids < 81
+				t.ajouter(CombinaisonCompacte::depuisIds(e.cartes[0], e.cartes[1], e.cartes[2]));
+	}
+
+	ostream &operator<<(ostream &f, const RapportJournal &r)
+	{
+		f << "octets                : " << r.nbOctets << "\n";
+		f << "parties               : " << r.nbParties << "\n";
+		f << "evenements            : " << r.nbEvenements << " (" << r.nbSets << " sets)\n";
+		f << "erreurs               : " << r.nbErreurs;
+		if (r.nbErreurs)
+			f << " (premiere a l'octet " << r.positionPremiereErreur << " : " << r.premiereErreur << ")";
+		f << "\n";
+		f << "debit                 : " << r.megaOctetsParSeconde() << " Mo/s (" << r.dureeSecondes << " s)\n";
+		return f;
+	}
+
+} // end of namespace Set
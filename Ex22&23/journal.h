@@ -0,0 +1,186 @@
+#ifndef _JOURNAL_H
+#define _JOURNAL_H
+
+#include "set.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * ============================================================================
+ * 二进制对局日志 (Binary Game Replay Log)
+ * ============================================================================
+ *
+ * 目的：记录每一局的全部事件（抽牌、上桌、移走、SET），用于审计、回放和调试
+ * 文本输出（operator<<）每个特征都要构造一个 string，太慢也太大
+ *
+ * 文件格式：
+ * - 文件头 8 字节："SETJ" + 版本号（1 字节）+ 3 字节保留
+ * - 然后是事件流，每个事件的第一个字节决定类型：
+ *     0   .. 80  : piocher(id)           1 字节
+ *     81  .. 161 : ajouter(id - 81)      1 字节
+ *     162 .. 242 : retirer(id - 162)     1 字节
+ *     243        : reclamer a b c        4 字节
+ *     244        : debut + 状态          33 字节（桌面掩码 16 字节 + 牌堆掩码 16 字节，小端）
+ *     245        : restaurer + 状态      33 字节
+ *     246        : fin                   1 字节
+ * - 一局完整的对局约 370 字节（每张卡的抽牌和上桌各 1 字节）
+ *
+ * 组成：
+ * - Journal: 写日志，实现 ObservateurControleur，挂到 Controleur 上即可自动记录
+ * - LecteurJournal: 用 mmap 映射整个文件，顺序解码，不分配内存；
+ *   可以校验（按规则重放每一局）或转换为文本
+ */
+namespace Set
+{
+	enum class TypeEvenement : std::uint8_t
+	{
+		piocher,
+		ajouter,
+		retirer,
+		reclamer,
+		debut,
+		restaurer,
+		fin
+	};
+
+	/**
+	 * Evenement: 解码后的一个事件
+	 * - cartes[0]：piocher / ajouter / retirer 的卡牌；cartes[0..3)：reclamer 的三张卡
+	 * - plateau / pioche：debut 和 restaurer 携带的状态
+	 */
+	struct Evenement
+	{
+		TypeEvenement type;
+		CarteId cartes[3];
+		MasqueCartes plateau;
+		MasqueCartes pioche;
+	};
+
+	/**
+	 * Journal: 二进制日志写入器
+	 *
+	 * 使用示例：
+	 *   std::ofstream fichier("parties.setj", std::ios::binary);
+	 *   Journal journal(fichier);
+	 *   Controleur c(graine);
+	 *   journal.debutPartie(c.sauvegarder());
+	 *   c.setObservateur(&journal);
+	 *   ... 对局 ...
+	 *   journal.finPartie();
+	 *
+	 * 事件先写入内存缓冲区，满 64 KB 或调用 vider() / 析构时才写到流中
+	 */
+	class Journal : public ObservateurControleur
+	{
+	private:
+		std::ostream &sortie;
+		std::vector<std::uint8_t> tampon;
+
+		void ecrireEtat(std::uint8_t code, const MasqueCartes &plateau, const MasqueCartes &pioche);
+		void verifierTampon()
+		{
+			if (tampon.size() >= TAILLE_TAMPON)
+				vider();
+		}
+
+	public:
+		static constexpr std::uint8_t VERSION = 1;
+		static constexpr size_t TAILLE_TAMPON = 64 * 1024;
+
+		/**
+		 * 构造时写入文件头
+		 */
+		explicit Journal(std::ostream &f);
+		~Journal() override;
+		Journal(const Journal &) = delete;
+		Journal &operator=(const Journal &) = delete;
+
+		void debutPartie(const EtatJeu &e);
+		void finPartie();
+
+		void piocher(CarteId id) override;
+		void ajouter(CarteId id) override;
+		void retirer(CarteId id) override;
+		void reclamer(const Triplet &t) override;
+		void restaurer(const EtatJeu &e) override;
+
+		/**
+		 * vider: 把缓冲区写到流中
+		 */
+		void vider();
+	};
+
+	/**
+	 * RapportJournal: 校验结果
+	 */
+	struct RapportJournal
+	{
+		size_t nbOctets = 0;
+		size_t nbParties = 0;
+		size_t nbEvenements = 0;
+		size_t nbSets = 0;
+		size_t nbErreurs = 0;
+		size_t positionPremiereErreur = 0; // 第一个错误事件在文件中的偏移
+		std::string premiereErreur;
+		double dureeSecondes = 0;
+
+		double megaOctetsParSeconde() const { return dureeSecondes > 0 ? nbOctets / dureeSecondes / 1e6 : 0; }
+	};
+
+	/**
+	 * LecteurJournal: 用 mmap 读取日志文件
+	 * 异常：文件无法打开、映射失败或文件头不正确时抛出 SetException
+	 */
+	class LecteurJournal
+	{
+	private:
+		const std::uint8_t *debut = nullptr;
+		size_t taille = 0;
+		size_t position = 0;
+
+	public:
+		explicit LecteurJournal(const std::string &chemin);
+		~LecteurJournal();
+		LecteurJournal(const LecteurJournal &) = delete;
+		LecteurJournal &operator=(const LecteurJournal &) = delete;
+
+		size_t getTaille() const { return taille; }
+		size_t getPosition() const { return position; }
+
+		/**
+		 * rembobiner: 回到第一个事件
+		 */
+		void rembobiner();
+
+		/**
+		 * suivant: 解码下一个事件
+		 * @return false 表示已到文件末尾
+		 * 异常：事件被截断或类型未知时抛出 SetException
+		 */
+		bool suivant(Evenement &e);
+
+		/**
+		 * verifier: 从头按规则重放所有对局，检查每个事件是否合法：
+		 * - piocher 的卡在牌堆中；ajouter 的卡刚被抽出且不在桌面上
+		 * - retirer 的卡在桌面上；reclamer 的三张卡互不相同、都在桌面上且构成 SET
+		 */
+		RapportJournal verifier();
+
+		/**
+		 * convertirEnTexte: 从头把所有事件转换为可读文本，每行一个事件
+		 */
+		void convertirEnTexte(ostream &f);
+
+		/**
+		 * collecterSets: 从头把所有 reclamer 事件的三张卡追加到 t（按文件顺序，不去重，不检查是否构成 SET）
+		 * 每个事件只占 4 字节；需要去重时再调用 t.normaliser()
+		 */
+		void collecterSets(TamponCombinaisons &t);
+	};
+
+	ostream &operator<<(ostream &f, const RapportJournal &r);
+
+} // end of namespace Set
+
+#endif // _JOURNAL_H
@@ -38,13 +38,9 @@ void afficherCartes(Forme f)
 	Jeu &jeu = Jeu::getInstance();
 	cout << "\n=== 使用 FormeIterator 遍历形状为 " << f << " 的卡牌 ===" << endl;
 
-	// 需要先找到第一张匹配的卡牌
+	// 迭代器创建时已经指向第一张匹配的卡牌
 	Jeu::FormeIterator it = jeu.firstFormeIterator(f);
 
-	// 找到第一张匹配的卡牌
-	while (!it.isDone() && it.getCurrentItem().getForme() != f)
-		it.next();
-
 	int count = 0;
 	while (!it.isDone())
 	{
@@ -79,32 +75,10 @@ void afficherCartes(const Plateau &p)
  */
 std::vector<Combinaison> trouverTousSets(const Plateau &p)
 {
+	// Plateau::findSets 基于卡牌编号和 81 位掩码，O(n²) 找出所有 SET
 	std::vector<Combinaison> sets;
-	size_t n = p.getNbCartes();
-
-	// 使用迭代器遍历所有三张卡的组合
-	std::vector<const Carte *> cartes;
-	for (Plateau::const_iterator it = p.begin(); it != p.end(); ++it)
-	{
-		cartes.push_back(&(*it));
-	}
-
-	// 三重循环检查所有可能的三张卡组合
-	for (size_t i = 0; i < n; i++)
-	{
-		for (size_t j = i + 1; j < n; j++)
-		{
-			for (size_t k = j + 1; k < n; k++)
-			{
-				Combinaison combo(*cartes[i], *cartes[j], *cartes[k]);
-				if (combo.estUnSet())
-				{
-					sets.push_back(combo);
-				}
-			}
-		}
-	}
-
+	for (const Triplet &t : p.findSets())
+		sets.push_back(Combinaison(t));
 	return sets;
 }
 
@@ -0,0 +1,103 @@
+/**
+ * ============================================================================
+ * 批量 SET 判断性能测试 (Batch Set Validation Benchmark)
+ * ============================================================================
+ *
+ * 对同一批随机三元组（约一半是 SET）比较：
+ * 1. 逐个调用 Combinaison::estUnSet()
+ * 2. 逐个调用基于编号的 estUnSet(a, b, c)
+ * 3. compterSetsLot 标量实现（SoA 通道）
+ * 4. compterSetsLot AVX2 实现（CPU 支持时）
+ * 5. validerLot（运行时选择的实现，写出逐个结果）
+ *
+ * 编译运行（在 outils 目录下）：
+ *   g++ -std=c++17 -O2 bench_lot.cpp ../setsimd.cpp ../set.cpp -o bench_lot && ./bench_lot
+ */
+
+#include "../setsimd.h"
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace Set;
+
+template <typename F>
+static double mesurer(size_t repetitions, size_t n, F f)
+{
+	auto t0 = std::chrono::steady_clock::now();
+	for (size_t r = 0; r < repetitions; r++)
+		f();
+	auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(repetitions * n);
+}
+
+int main()
+{
+	const size_t N = 1 << 20;
+	const size_t REPETITIONS = 10;
+
+	std::mt19937 rng(2024);
+	std::uniform_int_distribution<int> carte(0, config::NB_CARTES - 1);
+	std::vector<Triplet> triplets(N);
+	for (Triplet &t : triplets)
+	{
+		t.a = CarteId(carte(rng));
+		t.b = CarteId(carte(rng));
+		t.c = (rng() & 1) ? troisieme(t.a, t.b) : CarteId(carte(rng));
+	}
+
+	std::vector<Combinaison> combinaisons;
+	combinaisons.reserve(N);
+	LotTriplets lot;
+	lot.reserver(N);
+	for (const Triplet &t : triplets)
+	{
+		combinaisons.emplace_back(t);
+		lot.ajouter(t);
+	}
+	std::vector<std::uint8_t> resultats(N);
+
+	size_t attendu = 0;
+	for (const Combinaison &c : combinaisons)
+		attendu += c.estUnSet();
+
+	auto afficher = [&](const char *nom, double ns, size_t total)
+	{
+		cout << nom << " : " << ns << " ns/triplet"
+			 << (total == attendu * REPETITIONS ? "" : "  [RESULTATS DIFFERENTS !]") << "\n";
+	};
+
+	size_t total = 0;
+	double ns = mesurer(REPETITIONS, N, [&]()
+						{ for (const Combinaison &c : combinaisons) total += c.estUnSet(); });
+	afficher("Combinaison::estUnSet      ", ns, total);
+
+	total = 0;
+	ns = mesurer(REPETITIONS, N, [&]()
+				 { for (const Triplet &t : triplets) total += estUnSet(t.a, t.b, t.c); });
+	afficher("estUnSet(a, b, c)          ", ns, total);
+
+	total = 0;
+	ns = mesurer(REPETITIONS, N, [&]()
+				 { total += compterSetsLot(lot, ImplementationLot::scalaire); });
+	afficher("compterSetsLot (scalaire)  ", ns, total);
+
+	if (getImplementationLot() == ImplementationLot::avx2)
+	{
+		total = 0;
+		ns = mesurer(REPETITIONS, N, [&]()
+					 { total += compterSetsLot(lot, ImplementationLot::avx2); });
+		afficher("compterSetsLot (avx2)      ", ns, total);
+	}
+	else
+		cout << "AVX2 non disponible, implementation scalaire seulement\n";
+
+	total = 0;
+	ns = mesurer(REPETITIONS, N, [&]()
+				 {
+		validerLot(lot, resultats.data());
+		for (std::uint8_t r : resultats)
+			total += r; });
+	afficher("validerLot + somme         ", ns, total);
+	return 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * ============================================================================
+ * SET 查找性能测试 (Board-wide Set Enumeration Benchmark)
+ * ============================================================================
+ *
+ * 对比三种"统计桌面上所有 SET"的做法：
+ * 1. 朴素做法：三重循环构造每个 Combinaison 并调用 estUnSet()，O(n³)
+ * 2. compterSets()：81 位掩码 + 第三张卡查表，每次重新扫描，O(n²)
+ * 3. Plateau::countSets()：ajouter / retirer 时增量维护的计数，O(1)
+ *
+ * 另外在同一批桌面上检查 CombinaisonCompacte / TamponCombinaisons：
+ * - ajouterSets() 与 trouverSets() 找到的 SET 相同
+ * - Combinaison -> CombinaisonCompacte -> Combinaison 往返后是同三张卡
+ * - normaliser() / fusionner() 的结果有序、无重复，且与 std::set 计算的并集相同
+ *
+ * 编译运行（在 outils 目录下）：
+ *   g++ -std=c++17 -O2 bench_sets.cpp ../set.cpp -o bench_sets && ./bench_sets
+ */
+
+#include "../set.h"
+#include <chrono>
+#include <random>
+#include <set>
+#include <vector>
+#include <algorithm>
+
+using namespace Set;
+
+// 朴素做法：与原先 main.cpp 中的 trouverTousSets 相同
+static size_t compterSetsNaif(const Plateau &p)
+{
+	std::vector<const Carte *> cartes;
+	for (const Carte &c : p)
+		cartes.push_back(&c);
+
+	size_t nb = 0, n = cartes.size();
+	for (size_t i = 0; i < n; i++)
+		for (size_t j = i + 1; j < n; j++)
+			for (size_t k = j + 1; k < n; k++)
+				if (Combinaison(*cartes[i], *cartes[j], *cartes[k]).estUnSet())
+					nb++;
+	return nb;
+}
+
+// 严格递增即有序且无重复
+static bool estStrictementCroissant(const TamponCombinaisons &t)
+{
+	for (size_t i = 1; i < t.getTaille(); i++)
+		if (!(t[i - 1] < t[i]))
+			return false;
+	return true;
+}
+
+/**
+ * verifierTampon: 在一批桌面上检查紧凑表示和缓冲区，返回发现的错误数
+ */
+static size_t verifierTampon(const std::vector<std::vector<CarteId>> &ids)
+{
+	size_t nbErreurs = 0;
+	auto erreur = [&](const char *message)
+	{
+		if (nbErreurs++ < 5)
+			cout << "  ERREUR : " << message << "\n";
+	};
+
+	TamponCombinaisons precedent;
+	for (const std::vector<CarteId> &v : ids)
+	{
+		// 1. ajouterSets 与 trouverSets 一致（trouverSets 的 Triplet 也满足 a < b < c）
+		std::vector<Triplet> sets = trouverSets(v.data(), v.size());
+		TamponCombinaisons t;
+		t.ajouterSets(v.data(), v.size());
+		t.normaliser();
+		TamponCombinaisons attendu;
+		for (const Triplet &s : sets)
+			attendu.ajouter(s);
+		attendu.normaliser();
+		if (t.getTaille() != sets.size() || !std::equal(t.begin(), t.end(), attendu.begin(), attendu.end()))
+			erreur("ajouterSets et trouverSets different");
+
+		// 2. Combinaison <-> CombinaisonCompacte
+		for (const Triplet &s : sets)
+		{
+			Combinaison comb(s);
+			CombinaisonCompacte k = comb.versCompacte();
+			Combinaison retour(k);
+			if (k != CombinaisonCompacte(s.c, s.a, s.b) || CombinaisonCompacte::depuisCode(k.getCode()) != k ||
+				!k.estUnSet() || !(k.versTriplet() == s) ||
+				&retour.getCarte1() != &comb.getCarte1() || &retour.getCarte2() != &comb.getCarte2() ||
+				&retour.getCarte3() != &comb.getCarte3())
+				erreur("aller-retour Combinaison / CombinaisonCompacte");
+		}
+
+		// 3. normaliser() supprime les doublons ajoutes dans le desordre
+		TamponCombinaisons doublons;
+		for (size_t i = sets.size(); i-- > 0;)
+			doublons.ajouter(sets[i]);
+		for (const Triplet &s : sets)
+			doublons.ajouter(CombinaisonCompacte(s.b, s.c, s.a));
+		doublons.normaliser();
+		if (doublons.getTaille() != sets.size() || !doublons.estNormalise() || !estStrictementCroissant(doublons))
+			erreur("normaliser ne supprime pas les doublons");
+
+		// 4. fusionner() == union calculee avec std::set, y compris avec un tampon non normalise
+		std::set<std::uint32_t> reference;
+		for (CombinaisonCompacte c : t)
+			reference.insert(c.getCode());
+		for (CombinaisonCompacte c : precedent)
+			reference.insert(c.getCode());
+		TamponCombinaisons nonNormalise;
+		for (size_t i = t.getTaille(); i-- > 0;)
+		{
+			nonNormalise.ajouter(t[i]);
+			nonNormalise.ajouter(t[i]);
+		}
+		TamponCombinaisons union_ = precedent;
+		union_.fusionner(nonNormalise);
+		union_.fusionner(t);
+		bool egal = union_.getTaille() == reference.size() && estStrictementCroissant(union_);
+		for (size_t i = 0; egal && i < union_.getTaille(); i++)
+			egal = reference.count(union_[i].getCode()) && union_.contient(union_[i]);
+		if (!egal)
+			erreur("fusionner ne calcule pas l'union sans doublons");
+		precedent = t;
+	}
+	return nbErreurs;
+}
+
+int main()
+{
+	Jeu &jeu = Jeu::getInstance();
+	std::mt19937 rng(12345);
+	const size_t NB_PLATEAUX = 2000;
+	const size_t REPETITIONS = 20;
+
+	for (size_t taille : {12, 15, 18, 21})
+	{
+		// 随机生成 NB_PLATEAUX 个桌面（不含重复卡）
+		std::vector<Plateau> plateaux(NB_PLATEAUX);
+		std::vector<size_t> ordre(config::NB_CARTES);
+		for (size_t i = 0; i < ordre.size(); i++)
+			ordre[i] = i;
+		for (Plateau &p : plateaux)
+		{
+			std::shuffle(ordre.begin(), ordre.end(), rng);
+			for (size_t i = 0; i < taille; i++)
+				p.ajouter(jeu.getCarte(ordre[i]));
+		}
+
+		// 卡牌编号，供 compterSets 使用
+		std::vector<std::vector<CarteId>> ids(NB_PLATEAUX);
+		for (size_t i = 0; i < NB_PLATEAUX; i++)
+			for (const Carte &c : plateaux[i])
+				ids[i].push_back(c.getId());
+
+		size_t totalNaif = 0, totalBalayage = 0, totalRapide = 0;
+
+		auto t0 = std::chrono::steady_clock::now();
+		for (size_t r = 0; r < REPETITIONS; r++)
+			for (const Plateau &p : plateaux)
+				totalNaif += compterSetsNaif(p);
+		auto t1 = std::chrono::steady_clock::now();
+		for (size_t r = 0; r < REPETITIONS; r++)
+			for (const Plateau &p : plateaux)
+				totalRapide += p.countSets();
+		auto t2 = std::chrono::steady_clock::now();
+		for (size_t r = 0; r < REPETITIONS; r++)
+			for (const std::vector<CarteId> &v : ids)
+				totalBalayage += compterSets(v.data(), v.size());
+		auto t3 = std::chrono::steady_clock::now();
+
+		double n = double(NB_PLATEAUX * REPETITIONS);
+		double nsNaif = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+		double nsRapide = std::chrono::duration<double, std::nano>(t2 - t1).count() / n;
+		double nsBalayage = std::chrono::duration<double, std::nano>(t3 - t2).count() / n;
+
+		cout << taille << " cartes : naif " << nsNaif << " ns/plateau, compterSets "
+			 << nsBalayage << " ns/plateau (x" << nsNaif / nsBalayage << "), countSets "
+			 << nsRapide << " ns/plateau"
+			 << (totalNaif == totalRapide && totalNaif == totalBalayage ? "" : "  [RESULTATS DIFFERENTS !]") << "\n";
+
+		// ajouterSets (4 octets par SET, sans verifier) contre trouverSets (vector<Triplet>)
+		TamponCombinaisons tampon;
+		size_t totalTampon = 0;
+		auto t4 = std::chrono::steady_clock::now();
+		for (size_t r = 0; r < REPETITIONS; r++)
+			for (const std::vector<CarteId> &v : ids)
+			{
+				tampon.vider();
+				tampon.ajouterSets(v.data(), v.size());
+				totalTampon += tampon.getTaille();
+			}
+		auto t5 = std::chrono::steady_clock::now();
+		size_t totalTriplets = 0;
+		for (size_t r = 0; r < REPETITIONS; r++)
+			for (const std::vector<CarteId> &v : ids)
+				totalTriplets += trouverSets(v.data(), v.size()).size();
+		auto t6 = std::chrono::steady_clock::now();
+		size_t nbErreurs = verifierTampon(ids);
+
+		cout << "           ajouterSets " << std::chrono::duration<double, std::nano>(t5 - t4).count() / n
+			 << " ns/plateau, trouverSets " << std::chrono::duration<double, std::nano>(t6 - t5).count() / n
+			 << " ns/plateau"
+			 << (totalTampon == totalTriplets && totalTampon == totalRapide ? "" : "  [RESULTATS DIFFERENTS !]")
+			 << (nbErreurs ? "  [" + std::to_string(nbErreurs) + " ERREURS TamponCombinaisons]" : std::string())
+			 << "\n";
+		if (nbErreurs || totalTampon != totalTriplets)
+			return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,427 @@
+/**
+ * ============================================================================
+ * SET 模块热点性能测试套件 (Hot-path Benchmark Suite with Regression Baselines)
+ * ============================================================================
+ *
+ * 覆盖的热点：
+ * - estUnSet（编号查表）和 Combinaison::estUnSet
+ * - Pioche::piocher
+ * - Plateau::ajouter / retirer / 拷贝构造
+ * - Jeu 的各种迭代器：Iterator、IteratorBis、const_iterator、FiltreIterator、FormeIterator
+ * - Controleur 完整对局（distribuer + findSets + jouer，直到牌堆用完）
+ *
+ * 测量方法：
+ * 1. 标定：批量大小 n 不断翻倍，直到一批耗时 >= 1 ms（减小时钟开销的影响）
+ * 2. 预热：以该批量反复运行约 50 ms（填充缓存、分支预测器，让 CPU 升频）
+ * 3. 采样：运行 nbEchantillons 批，每批得到一个"纳秒/次"样本，报告 min / p50 / p90 / p99
+ *
+ * 用法：
+ *   ./benchmark [--echantillons N] [--filtre texte] [--sortie fichier] [--reference fichier] [--seuil pct]
+ * - --sortie：把结果写成 TSV（nom, n, min, p50, p90, p99），可作为以后的基准文件
+ * - --reference：与基准文件比较 p50，慢了超过 seuil%（默认 10）的项标记为 REGRESSION，
+ *   此时返回码为 2，方便在脚本中使用
+ *
+ * 编译运行（在 outils 目录下）：
+ *   g++ -std=c++17 -O2 benchmark.cpp ../set.cpp -o benchmark
+ *   ./benchmark --sortie reference.tsv          # 记录基准
+ *   ./benchmark --reference reference.tsv       # 修改代码后比较
+ */
+
+#include "../set.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace Set;
+
+namespace
+{
+	using Horloge = std::chrono::steady_clock;
+
+	/**
+	 * garder: 让编译器认为 x 被使用了，防止整个被测循环被优化掉
+	 */
+	template <typename T>
+	inline void garder(const T &x)
+	{
+		asm volatile("" : : "r,m"(x) : "memory");
+	}
+
+	double nanosecondes(Horloge::time_point t0, Horloge::time_point t1)
+	{
+		return std::chrono::duration<double, std::nano>(t1 - t0).count();
+	}
+
+	/**
+	 * Operation: 执行 n 次被测操作，返回耗时（纳秒）
+	 * 大多数操作直接用 chronometrer() 包装；需要排除准备工作的操作（如 retirer 前先填满桌面）自己计时
+	 */
+	using Operation = std::function<double(size_t)>;
+
+	template <typename F>
+	Operation chronometrer(F f)
+	{
+		return [f](size_t n) mutable
+		{
+			auto t0 = Horloge::now();
+			f(n);
+			return nanosecondes(t0, Horloge::now());
+		};
+	}
+
+	struct Benchmark
+	{
+		std::string nom;
+		Operation operation;
+	};
+
+	struct Resultat
+	{
+		std::string nom;
+		size_t n = 0; // 每批次数
+		double min = 0, p50 = 0, p90 = 0, p99 = 0;
+	};
+
+	Resultat mesurer(const Benchmark &b, size_t nbEchantillons)
+	{
+		// 标定
+		size_t n = 1;
+		while (b.operation(n) < 1e6 && n < (size_t(1) << 30))
+			n *= 2;
+		// 预热
+		auto debut = Horloge::now();
+		while (nanosecondes(debut, Horloge::now()) < 50e6)
+			b.operation(n);
+		// 采样
+		std::vector<double> echantillons(nbEchantillons);
+		for (double &e : echantillons)
+			e = b.operation(n) / double(n);
+		std::sort(echantillons.begin(), echantillons.end());
+
+		auto quantile = [&](double q)
+		{ return echantillons[std::min(echantillons.size() - 1, size_t(q * echantillons.size()))]; };
+		Resultat r;
+		r.nom = b.nom;
+		r.n = n;
+		r.min = echantillons.front();
+		r.p50 = quantile(0.5);
+		r.p90 = quantile(0.9);
+		r.p99 = quantile(0.99);
+		return r;
+	}
+
+	// ========================================================================
+	// 被测操作 (Benchmarked Operations)
+	// ========================================================================
+
+	std::vector<Benchmark> construireBenchmarks()
+	{
+		Jeu &jeu = Jeu::getInstance();
+		std::vector<Benchmark> liste;
+
+		// 随机三元组：约 1/79 是 SET，避免分支总是同一个方向
+		const size_t NB_TRIPLETS = 4096;
+		auto triplets = std::make_shared<std::vector<Triplet>>(NB_TRIPLETS);
+		auto combinaisons = std::make_shared<std::vector<Combinaison>>();
+		GenerateurAleatoire g(2024);
+		for (Triplet &t : *triplets)
+		{
+			t.a = CarteId(g.borne(config::NB_CARTES));
+			do
+				t.b = CarteId(g.borne(config::NB_CARTES));
+			while (t.b == t.a);
+			do
+				t.c = CarteId(g.borne(config::NB_CARTES));
+			while (t.c == t.a || t.c == t.b);
+			combinaisons->emplace_back(t);
+		}
+
+		liste.push_back({"estUnSet(CarteId)", chronometrer([triplets](size_t n)
+														   {
+			const Triplet *t = triplets->data();
+			size_t nb = 0;
+			for (size_t i = 0; i < n; i++)
+			{
+				const Triplet &x = t[i & (NB_TRIPLETS - 1)];
+				nb += estUnSet(x.a, x.b, x.c);
+			}
+			garder(nb); })});
+
+		liste.push_back({"Combinaison::estUnSet", chronometrer([combinaisons](size_t n)
+															   {
+			const Combinaison *c = combinaisons->data();
+			size_t nb = 0;
+			for (size_t i = 0; i < n; i++)
+				nb += c[i & (NB_TRIPLETS - 1)].estUnSet();
+			garder(nb); })});
+
+		// Pioche::piocher：每抽完 81 张用 setEtat 恢复，不重新分配
+		for (Pioche::ModeTirage mode : {Pioche::ModeTirage::aleatoire, Pioche::ModeTirage::melangee})
+		{
+			auto pioche = std::make_shared<Pioche>(jeu, GenerateurAleatoire(7), mode);
+			auto etat = std::make_shared<EtatPioche>(pioche->getEtat());
+			std::string nom = mode == Pioche::ModeTirage::aleatoire ? "Pioche::piocher (aleatoire)" : "Pioche::piocher (melangee)";
+			liste.push_back({nom, chronometrer([pioche, etat](size_t n)
+											   {
+				for (size_t i = 0; i < n; i++)
+				{
+					if (pioche->estVide())
+						pioche->setEtat(*etat);
+					garder(&pioche->piocher());
+				} })});
+		}
+
+		// Plateau：一组 64 个桌面，每个放 12 张随机卡；ajouter 和 retirer 分开计时
+		const size_t NB_PLATEAUX = 64, TAILLE = config::PLATEAU_MIN_CARTES;
+		auto plateaux = std::make_shared<std::vector<Plateau>>(NB_PLATEAUX);
+		auto contenus = std::make_shared<std::vector<const Carte *>>();
+		for (size_t p = 0; p < NB_PLATEAUX; p++)
+		{
+			CarteId ordre[config::NB_CARTES];
+			for (size_t i = 0; i < config::NB_CARTES; i++)
+				ordre[i] = CarteId(i);
+			for (size_t i = 0; i < TAILLE; i++)
+			{
+				std::swap(ordre[i], ordre[i + g.borne(std::uint32_t(config::NB_CARTES - i))]);
+				contenus->push_back(&jeu.getCarte(ordre[i]));
+			}
+		}
+		auto remplir = [plateaux, contenus]()
+		{
+			for (size_t p = 0; p < NB_PLATEAUX; p++)
+				for (size_t i = 0; i < TAILLE; i++)
+					(*plateaux)[p].ajouter(*(*contenus)[p * TAILLE + i]);
+		};
+		auto vider = [plateaux, contenus]()
+		{
+			// 按 i*5 mod 12 的顺序移走，不总是移走最后一张
+			for (size_t p = 0; p < NB_PLATEAUX; p++)
+				for (size_t i = 0; i < TAILLE; i++)
+					(*plateaux)[p].retirer(*(*contenus)[p * TAILLE + (i * 5) % TAILLE]);
+		};
+		// 一批固定是 64 × 12 次，n 向上取整到整批，返回值按实际次数折算
+		const size_t PAR_LOT = NB_PLATEAUX * TAILLE;
+		liste.push_back({"Plateau::ajouter", [plateaux, remplir](size_t n)
+						 {
+							 double ns = 0;
+							 size_t fait = 0;
+							 for (; fait < n; fait += PAR_LOT)
+							 {
+								 auto t0 = Horloge::now();
+								 remplir();
+								 ns += nanosecondes(t0, Horloge::now());
+								 for (Plateau &p : *plateaux)
+									 p.vider();
+							 }
+							 return ns * n / fait;
+						 }});
+		liste.push_back({"Plateau::retirer", [remplir, vider](size_t n)
+						 {
+							 double ns = 0;
+							 size_t fait = 0;
+							 for (; fait < n; fait += PAR_LOT)
+							 {
+								 remplir();
+								 auto t0 = Horloge::now();
+								 vider();
+								 ns += nanosecondes(t0, Horloge::now());
+							 }
+							 return ns * n / fait;
+						 }});
+
+		auto modele = std::make_shared<Plateau>();
+		for (size_t i = 0; i < TAILLE; i++)
+			modele->ajouter(*(*contenus)[i]);
+		liste.push_back({"Plateau(const Plateau&) 12 cartes", chronometrer([modele](size_t n)
+																		   {
+			for (size_t i = 0; i < n; i++)
+			{
+				Plateau copie(*modele);
+				garder(copie.getNbCartes());
+			} })});
+
+		// 迭代器：一次操作 = 完整遍历一次
+		liste.push_back({"Jeu::Iterator (81 cartes)", chronometrer([&jeu](size_t n)
+																   {
+			for (size_t i = 0; i < n; i++)
+				for (Jeu::Iterator it = jeu.first(); !it.isDone(); it.next())
+					garder(&it.getCurrentItem()); })});
+		liste.push_back({"Jeu::IteratorBis (81 cartes)", chronometrer([&jeu](size_t n)
+																	  {
+			for (size_t i = 0; i < n; i++)
+				for (Jeu::IteratorBis it = jeu.firstBis(); !it.isDone(); it.next())
+					garder(&it.getCurrentItem()); })});
+		liste.push_back({"Jeu::const_iterator (81 cartes)", chronometrer([&jeu](size_t n)
+																		 {
+			const Jeu &j = jeu;
+			for (size_t i = 0; i < n; i++)
+				for (const Carte &c : j)
+					garder(&c); })});
+		liste.push_back({"Jeu::FiltreIterator (9 cartes)", chronometrer([&jeu](size_t n)
+																		{
+			FiltreCartes f = FiltreCartes().couleur(Couleur::rouge).remplissage(Remplissage::plein);
+			for (size_t i = 0; i < n; i++)
+				for (Jeu::FiltreIterator it = jeu.firstFiltreIterator(f); !it.isDone(); it.next())
+					garder(&it.getCurrentItem()); })});
+		liste.push_back({"Jeu::FormeIterator (27 cartes)", chronometrer([&jeu](size_t n)
+																		{
+			for (size_t i = 0; i < n; i++)
+				for (Jeu::FormeIterator it = jeu.firstFormeIterator(Forme::ovale); !it.isDone(); it.next())
+					garder(&it.getCurrentItem()); })});
+
+		// 完整对局：与 outils/journal.cpp 的对局循环相同，每局使用不同的流
+		auto partie = std::make_shared<std::uint64_t>(0);
+		liste.push_back({"Controleur partie complete", chronometrer([partie](size_t n)
+																	{
+			for (size_t i = 0; i < n; i++)
+			{
+				Controleur c(1, (*partie)++);
+				c.distribuer();
+				while (true)
+				{
+					std::vector<Triplet> sets = c.getPlateau().findSets();
+					if (!sets.empty())
+						c.jouer(Combinaison(sets.front()));
+					else if (c.getPioche().estVide())
+						break;
+					c.distribuer();
+				}
+				garder(c.getPlateau().getNbCartes());
+			} })});
+
+		return liste;
+	}
+
+	// ========================================================================
+	// 结果文件 (Result Files)
+	// ========================================================================
+
+	const char *ENTETE_TSV = "# nom\tn\tmin_ns\tp50_ns\tp90_ns\tp99_ns";
+
+	void ecrireTsv(const std::string &chemin, const std::vector<Resultat> &resultats)
+	{
+		std::ofstream f(chemin);
+		if (!f)
+			throw SetException("impossible de creer " + chemin);
+		f << ENTETE_TSV << "\n";
+		for (const Resultat &r : resultats)
+			f << r.nom << "\t" << r.n << "\t" << r.min << "\t" << r.p50 << "\t" << r.p90 << "\t" << r.p99 << "\n";
+	}
+
+	std::map<std::string, Resultat> lireTsv(const std::string &chemin)
+	{
+		std::ifstream f(chemin);
+		if (!f)
+			throw SetException("impossible d'ouvrir " + chemin);
+		std::map<std::string, Resultat> m;
+		std::string ligne;
+		while (std::getline(f, ligne))
+		{
+			if (ligne.empty() || ligne[0] == '#')
+				continue;
+			size_t tab = ligne.find('\t');
+			if (tab == std::string::npos)
+				throw SetException("ligne invalide dans " + chemin + " : " + ligne);
+			Resultat r;
+			r.nom = ligne.substr(0, tab);
+			std::istringstream valeurs(ligne.substr(tab + 1));
+			if (!(valeurs >> r.n >> r.min >> r.p50 >> r.p90 >> r.p99))
+				throw SetException("ligne invalide dans " + chemin + " : " + ligne);
+			m[r.nom] = r;
+		}
+		return m;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	size_t nbEchantillons = 30;
+	std::string filtre, sortie, reference;
+	double seuil = 10;
+	for (int i = 1; i < argc; i++)
+	{
+		auto valeur = [&]() -> const char *
+		{
+			if (i + 1 >= argc)
+			{
+				cout << "option " << argv[i] << " sans valeur\n";
+				std::exit(1);
+			}
+			return argv[++i];
+		};
+		if (std::strcmp(argv[i], "--echantillons") == 0)
+			nbEchantillons = std::max<size_t>(1, std::strtoull(valeur(), nullptr, 10));
+		else if (std::strcmp(argv[i], "--filtre") == 0)
+			filtre = valeur();
+		else if (std::strcmp(argv[i], "--sortie") == 0)
+			sortie = valeur();
+		else if (std::strcmp(argv[i], "--reference") == 0)
+			reference = valeur();
+		else if (std::strcmp(argv[i], "--seuil") == 0)
+			seuil = std::strtod(valeur(), nullptr);
+		else
+		{
+			cout << "usage : benchmark [--echantillons N] [--filtre texte] [--sortie fichier] "
+					"[--reference fichier] [--seuil pct]\n";
+			return 1;
+		}
+	}
+
+	try
+	{
+		std::map<std::string, Resultat> base;
+		if (!reference.empty())
+			base = lireTsv(reference);
+
+		std::vector<Resultat> resultats;
+		size_t nbRegressions = 0;
+		cout << std::left << std::setw(36) << "benchmark" << std::right << std::setw(10) << "min" << std::setw(10)
+			 << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99" << "  (ns/op)\n";
+		cout << std::fixed << std::setprecision(2);
+		for (const Benchmark &b : construireBenchmarks())
+		{
+			if (!filtre.empty() && b.nom.find(filtre) == std::string::npos)
+				continue;
+			Resultat r = mesurer(b, nbEchantillons);
+			resultats.push_back(r);
+			cout << std::left << std::setw(36) << r.nom << std::right << std::setw(10) << r.min << std::setw(10) << r.p50
+				 << std::setw(10) << r.p90 << std::setw(10) << r.p99;
+			if (!reference.empty())
+			{
+				auto it = base.find(r.nom);
+				if (it == base.end())
+					cout << "  (absent de la reference)";
+				else
+				{
+					double ecart = (r.p50 / it->second.p50 - 1) * 100;
+					cout << "  " << std::showpos << ecart << std::noshowpos << "%";
+					if (ecart > seuil)
+					{
+						cout << "  REGRESSION";
+						nbRegressions++;
+					}
+				}
+			}
+			cout << std::endl;
+		}
+
+		if (!sortie.empty())
+			ecrireTsv(sortie, resultats);
+		if (!reference.empty())
+			cout << nbRegressions << " regression(s) au-dela de " << seuil << "%\n";
+		return nbRegressions ? 2 : 0;
+	}
+	catch (SetException &e)
+	{
+		cout << "Exception: " << e.getInfo() << "\n";
+		return 1;
+	}
+}
@@ -0,0 +1,140 @@
+/**
+ * ============================================================================
+ * 规范形式缓存命中率测试 (Canonical-form Cache Hit-rate Benchmark)
+ * ============================================================================
+ *
+ * 用法：./canonique [nbParties] [graine]
+ * - 用 Controleur 模拟 nbParties 局（每次拿第一个找到的 SET），记录每次发牌后的桌面
+ * - 对比两种缓存键：桌面掩码本身 vs 规范形式，按桌面张数分别统计命中率
+ * - 测量 canonique() 的耗时，以及 trouverSets 与 trouverSetsCanonique 的耗时
+ *
+ * 编译运行（在 outils 目录下）：
+ *   g++ -std=c++17 -O2 canonique.cpp ../symetrie.cpp ../set.cpp -o canonique && ./canonique 10000
+ */
+
+#include "../symetrie.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <unordered_set>
+
+using namespace Set;
+
+namespace
+{
+	struct HashMasque
+	{
+		size_t operator()(const MasqueCartes &m) const { return size_t(hashZobrist(m, MasqueCartes())); }
+	};
+
+	/**
+	 * Compteurs: 某一桌面张数下的统计
+	 */
+	struct Compteurs
+	{
+		size_t nbPlateaux = 0;
+		std::unordered_set<MasqueCartes, HashMasque> exacts;
+		std::unordered_set<MasqueCartes, HashMasque> classes;
+	};
+
+	size_t versIds(const MasqueCartes &m, CarteId *ids)
+	{
+		size_t n = 0;
+		m.pourChaque([&](CarteId id)
+					 { ids[n++] = id; });
+		return n;
+	}
+
+	double taux(size_t distincts, size_t total) { return total ? 100.0 * (1.0 - double(distincts) / double(total)) : 0; }
+}
+
+int main(int argc, char *argv[])
+{
+	size_t nbParties = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+	std::uint64_t graine = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1;
+
+	try
+	{
+		// 1. 模拟对局，收集每次发牌后的桌面
+		std::vector<MasqueCartes> plateaux;
+		for (size_t i = 0; i < nbParties; i++)
+		{
+			Controleur c(graine, i);
+			c.distribuer();
+			while (true)
+			{
+				plateaux.push_back(c.getPlateau().getMasque());
+				std::vector<Triplet> sets = c.getPlateau().findSets();
+				if (!sets.empty())
+					c.jouer(Combinaison(sets.front()));
+				else if (c.getPioche().estVide())
+					break;
+				c.distribuer();
+			}
+		}
+
+		// 2. 命中率：缓存从空开始，依次查询所有桌面；命中率 = 1 - 不同键的个数 / 查询次数
+		std::map<size_t, Compteurs> parTaille;
+		Compteurs total;
+		CacheCanonique<size_t> cache;
+		for (const MasqueCartes &m : plateaux)
+		{
+			FormeCanonique f = canonique(m);
+			cache.obtenir(f, [&]()
+						  {
+				CarteId ids[config::NB_CARTES];
+				return compterSets(ids, versIds(f.plateau, ids)); });
+			for (Compteurs *c : {&parTaille[m.getNbCartes()], &total})
+			{
+				c->nbPlateaux++;
+				c->exacts.insert(m);
+				c->classes.insert(f.plateau);
+			}
+		}
+
+		cout << plateaux.size() << " plateaux (" << nbParties << " parties)\n";
+		cout << std::fixed << std::setprecision(2);
+		cout << "cartes   plateaux   distincts   classes   succes(exact)   succes(canonique)\n";
+		for (auto &[taille, c] : parTaille)
+			cout << std::setw(6) << taille << std::setw(11) << c.nbPlateaux << std::setw(12) << c.exacts.size()
+				 << std::setw(10) << c.classes.size() << std::setw(15) << taux(c.exacts.size(), c.nbPlateaux) << "%"
+				 << std::setw(19) << taux(c.classes.size(), c.nbPlateaux) << "%\n";
+		cout << " total" << std::setw(11) << total.nbPlateaux << std::setw(12) << total.exacts.size() << std::setw(10)
+			 << total.classes.size() << std::setw(15) << taux(total.exacts.size(), total.nbPlateaux) << "%" << std::setw(19)
+			 << taux(total.classes.size(), total.nbPlateaux) << "%\n";
+		cout << "CacheCanonique : " << cache.getNbSucces() << " succes, " << cache.getNbEchecs() << " echecs ("
+			 << 100 * cache.tauxSucces() << "%)\n";
+
+		// 3. 耗时
+		auto ns = [&](auto debut, auto fin)
+		{ return std::chrono::duration<double, std::nano>(fin - debut).count() / double(plateaux.size()); };
+		size_t nbCartes = 0, nbSetsDirects = 0, nbSetsCanoniques = 0;
+		auto t2 = std::chrono::steady_clock::now();
+		for (const MasqueCartes &m : plateaux)
+			nbCartes += canonique(m).plateau.getNbCartes();
+		auto t3 = std::chrono::steady_clock::now();
+		for (const MasqueCartes &m : plateaux)
+		{
+			CarteId ids[config::NB_CARTES];
+			nbSetsDirects += trouverSets(ids, versIds(m, ids)).size();
+		}
+		auto t4 = std::chrono::steady_clock::now();
+		CacheCanonique<std::vector<Triplet>> cacheSets;
+		for (const MasqueCartes &m : plateaux)
+			nbSetsCanoniques += trouverSetsCanonique(m, cacheSets).size();
+		auto t5 = std::chrono::steady_clock::now();
+
+		cout << "canonique()          : " << ns(t2, t3) << " ns/plateau (" << nbCartes / plateaux.size() << " cartes en moyenne)\n";
+		cout << "trouverSets          : " << ns(t3, t4) << " ns/plateau\n";
+		cout << "trouverSetsCanonique : " << ns(t4, t5) << " ns/plateau (" << 100 * cacheSets.tauxSucces() << "% succes)\n";
+		if (nbSetsDirects != nbSetsCanoniques)
+			cout << "[RESULTATS DIFFERENTS !]\n";
+	}
+	catch (SetException &e)
+	{
+		cout << "Exception: " << e.getInfo() << "\n";
+		return 1;
+	}
+	return 0;
+}
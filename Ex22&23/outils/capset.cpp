@@ -0,0 +1,362 @@
+/**
+ * ============================================================================
+ * 无 SET 卡牌集合搜索工具 (Cap-set Search over AG(4,3))
+ * ============================================================================
+ *
+ * 81 张卡牌就是 F₃⁴ 中的 81 个点（卡牌编号的 4 位三进制数字就是坐标），
+ * 三张卡构成 SET ⇔ 三点共线。不含 SET 的卡牌集合称为 cap set。
+ * 本工具求最大 cap set 的大小，并统计该大小的 cap set 一共有多少个，
+ * 用来核对 config::TAILLE_MAX_SANS_SET（发牌的最坏情况：桌面最多 TAILLE_MAX_SANS_SET + 1 张）
+ *
+ * 用法：./capset [taille] [nbThreads]
+ * - 不给 taille：先求最大大小，再统计该大小的 cap set 个数
+ * - 给定 taille：只统计大小为 taille 的 cap set 个数（taille >= 3）
+ * - nbThreads 为 0（默认）时使用所有核心
+ *
+ * 算法：位集分支定界（branch and bound）
+ * - 状态：已选的点 + 候选掩码（编号大于最后一个已选点、且不与任意两个已选点共线）
+ * - 选入点 p 时，对每个已选点 q，把第三点 troisieme(p, q) 从候选中删掉
+ * - 剪枝：已选个数 + 候选个数 < 目标大小；
+ *   更紧的上界：每个超平面（27 个点，即 AG(3,3)）中最多 9 张，对 40 个方向取最小
+ *
+ * 对称性破缺：仿射群 AGL(4,3) 在"不共线的有序三点组"上是传递的，
+ * 所以只需搜索包含固定三点 {0, 1, 3} 的 cap set（编号 0、1、3 即坐标 0000、0001、0010）
+ * 设 C 为包含这三点、大小为 k 的 cap set 个数，则总数 N 满足
+ *   N · k(k-1)(k-2) = 81 · 80 · 78 · C
+ * （两边都在数"cap set + 其中一个有序三点组"的对数）
+ *
+ * 并行：固定三点之后，再选两个点作为一个任务，任务按顺序放进共享队列，线程用原子计数器领取
+ *
+ * 编译运行（在 outils 目录下）：
+ *   g++ -std=c++17 -O2 -pthread capset.cpp ../set.cpp -o capset && ./capset
+ */
+
+#include "../set.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Set;
+
+namespace
+{
+	const CarteId FIXES[3] = {0, 1, 3};
+
+	/**
+	 * 超平面：F₃⁴ 中共有 40 个方向（射影点），每个方向把 81 张卡分成 3 个平行超平面，每个 27 张
+	 * 超平面本身是 AG(3,3)，其中的 cap set 最多 MAX_PAR_HYPERPLAN = 9 张
+	 * （可以用本工具同样的方法在 27 个点上验证，只需不到一毫秒）
+	 */
+	constexpr size_t NB_DIRECTIONS = 40;
+	constexpr size_t MAX_PAR_HYPERPLAN = 9;
+
+	struct Hyperplans
+	{
+		MasqueCartes masques[NB_DIRECTIONS][3];
+
+		Hyperplans()
+		{
+			size_t d = 0;
+			for (unsigned u = 1; u < config::NB_CARTES; u++)
+			{
+				// 只取第一个非零坐标为 1 的方向向量，每个方向恰好一次
+				size_t k = 0;
+				while (chiffre(CarteId(u), k) == 0)
+					k++;
+				if (chiffre(CarteId(u), k) != 1)
+					continue;
+				for (unsigned id = 0; id < config::NB_CARTES; id++)
+				{
+					unsigned produit = 0;
+					for (size_t a = 0; a < config::NB_ATTRIBUTS; a++)
+						produit += chiffre(CarteId(u), a) * chiffre(CarteId(id), a);
+					masques[d][produit % 3].ajouter(CarteId(id));
+				}
+				d++;
+			}
+		}
+	};
+
+	const Hyperplans HYPERPLANS;
+
+	/**
+	 * borne: cap set 的最大可能大小（已选 + 还能加入的）
+	 * 对每个方向：三个平行超平面各自最多 MAX_PAR_HYPERPLAN 张，取所有方向中最紧的一个
+	 * 同时删掉已经放满的超平面中的候选
+	 */
+	size_t borne(const MasqueCartes &choisis, MasqueCartes &candidats)
+	{
+		size_t meilleure = choisis.getNbCartes() + candidats.getNbCartes();
+		for (size_t d = 0; d < NB_DIRECTIONS; d++)
+		{
+			size_t somme = 0;
+			for (size_t c = 0; c < 3; c++)
+			{
+				const MasqueCartes &h = HYPERPLANS.masques[d][c];
+				size_t dedans = (choisis & h).getNbCartes();
+				if (dedans == MAX_PAR_HYPERPLAN)
+				{
+					candidats.mots[0] &= ~h.mots[0];
+					candidats.mots[1] &= ~h.mots[1];
+				}
+				somme += std::min(MAX_PAR_HYPERPLAN, dedans + (candidats & h).getNbCartes());
+			}
+			meilleure = std::min(meilleure, somme);
+		}
+		return meilleure;
+	}
+
+	/**
+	 * Tache: 固定三点之后的两个点，以及此时的候选掩码
+	 */
+	struct Tache
+	{
+		CarteId p, q;
+		MasqueCartes candidats;
+	};
+
+	/**
+	 * Recherche: 一次搜索（求最大或计数）的共享状态
+	 */
+	class Recherche
+	{
+	private:
+		const bool maximiser;
+		std::atomic<size_t> cible;	 // 计数：目标大小；求最大：当前最优
+		std::atomic<std::uint64_t> nbTrouvees{0};
+		std::atomic<std::uint64_t> nbNoeuds{0};
+		std::mutex verrou;
+		std::vector<CarteId> exemple;
+
+		/**
+		 * ajouterPoint: 把 p 加入 choisis[0..n)，返回删掉新共线点后的候选
+		 */
+		static MasqueCartes ajouterPoint(const CarteId *choisis, size_t n, CarteId p, MasqueCartes candidats)
+		{
+			for (size_t i = 0; i < n; i++)
+				candidats.retirer(troisieme(p, choisis[i]));
+			return candidats;
+		}
+
+		static MasqueCartes superieursA(CarteId p)
+		{
+			MasqueCartes m;
+			for (size_t id = p + 1; id < config::NB_CARTES; id++)
+				m.ajouter(CarteId(id));
+			return m;
+		}
+
+		void trouvee(const CarteId *choisis, size_t n)
+		{
+			std::lock_guard<std::mutex> l(verrou);
+			if (exemple.size() < n)
+				exemple.assign(choisis, choisis + n);
+		}
+
+		/**
+		 * explorer: choisis[0..n) 已选（masque 是同一集合的掩码），
+		 * candidats 中的点都可以加入（编号递增，每个集合只访问一次）
+		 * 返回本子树访问的节点数
+		 */
+		std::uint64_t explorer(CarteId *choisis, size_t n, const MasqueCartes &masque, MasqueCartes candidats,
+							   std::uint64_t &trouvees)
+		{
+			std::uint64_t noeuds = 1;
+			if (maximiser)
+			{
+				size_t meilleur = cible.load(std::memory_order_relaxed);
+				if (n > meilleur)
+				{
+					// 可能有多个线程同时改进，只保留最大值
+					while (n > meilleur && !cible.compare_exchange_weak(meilleur, n, std::memory_order_relaxed))
+						;
+					trouvee(choisis, n);
+				}
+			}
+			else if (n == cible.load(std::memory_order_relaxed))
+			{
+				if (trouvees++ == 0)
+					trouvee(choisis, n);
+				return noeuds;
+			}
+
+			// 剪枝：即使剩下的候选全部加入也达不到目标
+			auto seuil = [&]()
+			{ return cible.load(std::memory_order_relaxed) + (maximiser ? 1 : 0); };
+			if (borne(masque, candidats) < seuil())
+				return noeuds;
+
+			size_t reste = candidats.getNbCartes();
+			while (reste > 0 && n + reste >= seuil())
+			{
+				CarteId p = CarteId(candidats.mots[0] ? __builtin_ctzll(candidats.mots[0])
+													  : 64 + __builtin_ctzll(candidats.mots[1]));
+				candidats.retirer(p);
+				reste--;
+				MasqueCartes suivants = ajouterPoint(choisis, n, p, candidats);
+				MasqueCartes avecP = masque;
+				avecP.ajouter(p);
+				choisis[n] = p;
+				noeuds += explorer(choisis, n + 1, avecP, suivants, trouvees);
+			}
+			return noeuds;
+		}
+
+	public:
+		Recherche(bool maxi, size_t c) : maximiser(maxi), cible(c) {}
+
+		void lancer(unsigned nbThreads)
+		{
+			// 固定三点之后的候选
+			MasqueCartes depart = MASQUE_JEU_COMPLET;
+			for (size_t i = 0; i < 3; i++)
+			{
+				depart.retirer(FIXES[i]);
+				for (size_t j = 0; j < i; j++)
+					depart.retirer(troisieme(FIXES[i], FIXES[j]));
+			}
+
+			// 任务：再选两个点 p < q
+			std::vector<Tache> taches;
+			depart.pourChaque([&](CarteId p)
+							  {
+				MasqueCartes apresP = ajouterPoint(FIXES, 3, p, depart & superieursA(p));
+				CarteId avecP[4] = {FIXES[0], FIXES[1], FIXES[2], p};
+				apresP.pourChaque([&](CarteId q)
+								  { taches.push_back(Tache{p, q, ajouterPoint(avecP, 4, q, apresP & superieursA(q))}); }); });
+
+			// 大小为 3 或 4 的集合比任务还小，直接得出
+			if (!maximiser && cible.load() <= 4)
+			{
+				CarteId choisis[4] = {FIXES[0], FIXES[1], FIXES[2]};
+				if (cible.load() == 3)
+					nbTrouvees = 1;
+				else
+				{
+					nbTrouvees = depart.getNbCartes();
+					choisis[3] = CarteId(__builtin_ctzll(depart.mots[0]));
+				}
+				trouvee(choisis, cible.load());
+				return;
+			}
+
+			std::atomic<size_t> prochaine{0};
+			auto travailler = [&]()
+			{
+				std::uint64_t trouvees = 0, noeuds = 0;
+				CarteId choisis[config::NB_CARTES];
+				std::copy(FIXES, FIXES + 3, choisis);
+				for (size_t i; (i = prochaine.fetch_add(1, std::memory_order_relaxed)) < taches.size();)
+				{
+					choisis[3] = taches[i].p;
+					choisis[4] = taches[i].q;
+					MasqueCartes masque;
+					for (size_t k = 0; k < 5; k++)
+						masque.ajouter(choisis[k]);
+					noeuds += explorer(choisis, 5, masque, taches[i].candidats, trouvees);
+				}
+				nbTrouvees += trouvees;
+				nbNoeuds += noeuds;
+			};
+
+			if (nbThreads == 0)
+				nbThreads = std::max(1u, std::thread::hardware_concurrency());
+			std::vector<std::thread> threads;
+			for (unsigned t = 1; t < nbThreads; t++)
+				threads.emplace_back(travailler);
+			travailler();
+			for (std::thread &t : threads)
+				t.join();
+		}
+
+		size_t getCible() const { return cible.load(); }
+		std::uint64_t getNbTrouvees() const { return nbTrouvees.load(); }
+		std::uint64_t getNbNoeuds() const { return nbNoeuds.load(); }
+		const std::vector<CarteId> &getExemple() const { return exemple; }
+	};
+
+	/**
+	 * total: N = 81 · 80 · 78 · C / (k(k-1)(k-2))
+	 * 用 128 位整数避免溢出（k = 20 时 N 约为 7·10⁵，中间结果很小，但 k 较小时 C 可能很大）
+	 */
+	unsigned __int128 total(std::uint64_t c, size_t k)
+	{
+		unsigned __int128 n = (unsigned __int128)c * config::NB_CARTES * (config::NB_CARTES - 1) * (config::NB_CARTES - 3);
+		return n / (k * (k - 1) * (k - 2));
+	}
+
+	ostream &operator<<(ostream &f, unsigned __int128 x)
+	{
+		char chiffres[40];
+		size_t n = 0;
+		do
+		{
+			chiffres[n++] = char('0' + unsigned(x % 10));
+			x /= 10;
+		} while (x);
+		while (n)
+			f << chiffres[--n];
+		return f;
+	}
+
+	void afficherExemple(const std::vector<CarteId> &ids)
+	{
+		char memoire[TAILLE_MAX_RENDU_PLATEAU * 4];
+		TamponRendu t(memoire, sizeof(memoire));
+		rendrePlateau(t, ids.data(), ids.size());
+		cout << "exemple (" << ids.size() << " cartes, " << compterSets(ids.data(), ids.size()) << " set) :\n";
+		cout.write(t.getTexte().data(), std::streamsize(t.getTaille()));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	size_t taille = 0;
+	unsigned nbThreads = 0;
+	if (argc > 1)
+		taille = std::strtoull(argv[1], nullptr, 10);
+	if (argc > 2)
+		nbThreads = unsigned(std::strtoul(argv[2], nullptr, 10));
+	if (argc > 1 && (taille < 3 || taille > config::NB_CARTES))
+	{
+		cout << "usage : capset [taille >= 3] [nbThreads]\n";
+		return 1;
+	}
+
+	try
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		if (taille == 0)
+		{
+			Recherche r(true, 5);
+			r.lancer(nbThreads);
+			taille = r.getCible();
+			cout << "taille maximale sans set : " << taille << " (" << r.getNbNoeuds() << " noeuds, "
+				 << std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() << " s)\n";
+			if (taille == config::TAILLE_MAX_SANS_SET)
+				cout << "coherent avec config::TAILLE_MAX_SANS_SET (plateau maximal : " << config::PLATEAU_MAX_CARTES << " cartes)\n";
+			else
+				cout << "[INCOHERENCE : config::TAILLE_MAX_SANS_SET = " << config::TAILLE_MAX_SANS_SET << "]\n";
+			t0 = std::chrono::steady_clock::now();
+		}
+
+		Recherche r(false, taille);
+		r.lancer(nbThreads);
+		double duree = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		cout << "cap sets de " << taille << " cartes contenant {0, 1, 3} : " << r.getNbTrouvees() << "\n";
+		cout << "cap sets de " << taille << " cartes au total       : " << total(r.getNbTrouvees(), taille) << "\n";
+		cout << "noeuds explores : " << r.getNbNoeuds() << ", " << duree << " s\n";
+		if (!r.getExemple().empty())
+			afficherExemple(r.getExemple());
+	}
+	catch (SetException &e)
+	{
+		cout << "Exception: " << e.getInfo() << "\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,44 @@
+/**
+ * ============================================================================
+ * 多桌负载生成工具 (Multi-table Load Generator)
+ * ============================================================================
+ *
+ * 用法：./charge [nbTables] [nbJoueurs] [nbThreads] [graine]
+ * - 所有桌子同时开局，机器人不断提交 SET，直到每张桌子都结束
+ * - 打印每秒提交数、p50 / p99 提交延迟，并检查每张桌子的得分之和
+ *
+ * 编译运行（在 outils 目录下）：
+ *   g++ -std=c++17 -O2 -pthread charge.cpp ../serveur.cpp ../set.cpp -o charge && ./charge 10000 4
+ */
+
+#include "../serveur.h"
+#include <cstdlib>
+
+using namespace Set;
+
+int main(int argc, char *argv[])
+{
+	ParametresServeur p;
+	if (argc > 1)
+		p.nbTables = std::strtoull(argv[1], nullptr, 10);
+	if (argc > 2)
+		p.nbJoueurs = std::strtoull(argv[2], nullptr, 10);
+	if (argc > 3)
+		p.nbThreads = unsigned(std::strtoul(argv[3], nullptr, 10));
+	if (argc > 4)
+		p.graine = std::strtoull(argv[4], nullptr, 10);
+
+	try
+	{
+		StatistiquesServeur s = ServeurTables(p).lancer();
+		cout << s;
+		// 每个被接受的提交恰好拿走一个 SET，一局最多 27 个
+		if (s.nbAcceptees > p.nbTables * (config::NB_CARTES / 3))
+			cout << "[INCOHERENCE : trop de sets acceptes]\n";
+	}
+	catch (SetException &e)
+	{
+		cout << "Exception: " << e.getInfo() << "\n";
+	}
+	return 0;
+}
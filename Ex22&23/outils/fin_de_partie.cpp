@@ -0,0 +1,60 @@
+/**
+ * ============================================================================
+ * 残局求解命令行工具 (Endgame Solver Driver)
+ * ============================================================================
+ *
+ * 用法：./fin_de_partie [nbPioche] [nbThreads] [graine]
+ * - 用 Controleur(graine) 随机对局（每次拿第一个找到的 SET），直到牌堆只剩 nbPioche 张（默认 12）
+ * - 然后从这个局面开始穷举求解，打印结果和搜索统计
+ * - nbThreads 为 0（默认）时使用所有核心
+ *
+ * 编译运行（在 outils 目录下）：
+ *   g++ -std=c++17 -O2 -pthread fin_de_partie.cpp ../solveur.cpp ../set.cpp -o fin_de_partie && ./fin_de_partie 15
+ */
+
+#include "../solveur.h"
+#include <cstdlib>
+
+using namespace Set;
+
+int main(int argc, char *argv[])
+{
+	size_t nbPioche = 12;
+	unsigned nbThreads = 0;
+	std::uint64_t graine = 1;
+	if (argc > 1)
+		nbPioche = std::strtoull(argv[1], nullptr, 10);
+	if (argc > 2)
+		nbThreads = unsigned(std::strtoul(argv[2], nullptr, 10));
+	if (argc > 3)
+		graine = std::strtoull(argv[3], nullptr, 10);
+
+	try
+	{
+		Controleur c(graine);
+		c.distribuer();
+		while (c.getPioche().getNbCartes() > nbPioche)
+		{
+			std::vector<Triplet> sets = c.getPlateau().findSets();
+			if (!sets.empty())
+				c.jouer(Combinaison(sets.front()));
+			c.distribuer();
+		}
+
+		EtatJeu e = c.sauvegarder();
+		cout << "plateau : " << c.getPlateau().getNbCartes() << " cartes, pioche : "
+			 << c.getPioche().getNbCartes() << " cartes\n";
+		cout << c.getPlateau();
+
+		SolveurFinDePartie solveur(e.plateau, e.getMasquePioche(), nbThreads);
+		cout << solveur.resoudre();
+		const StatistiquesSolveur &s = solveur.getStatistiques();
+		cout << "etats memorises : " << s.nbEtats << ", taches : " << s.nbTaches
+			 << " (" << s.nbVols << " volees), " << s.dureeSecondes << " s\n";
+	}
+	catch (SetException &e)
+	{
+		cout << "Exception: " << e.getInfo() << "\n";
+	}
+	return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * ============================================================================
+ * 对局日志命令行工具 (Game Replay Log Driver)
+ * ============================================================================
+ *
+ * 用法：
+ *   ./journal generer <fichier> [nbParties] [graine]   用 Controleur 对局并记录日志
+ *   ./journal verifier <fichier>                       按规则重放所有对局并报告吞吐量
+ *   ./journal texte <fichier>                          转换为可读文本（输出到标准输出）
+ *   ./journal sets <fichier>                           统计所有对局中拿走的 SET（总数、不同的 SET 数）
+ *
+ * 编译运行（在 outils 目录下）：
+ *   g++ -std=c++17 -O2 journal.cpp ../journal.cpp ../set.cpp -o journal
+ *   ./journal generer parties.setj 100000 && ./journal verifier parties.setj
+ */
+
+#include "../journal.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+using namespace Set;
+
+static void generer(const char *chemin, size_t nbParties, std::uint64_t graine)
+{
+	std::ofstream fichier(chemin, std::ios::binary);
+	if (!fichier)
+		throw SetException(std::string("impossible de creer ") + chemin);
+	Journal journal(fichier);
+	for (size_t i = 0; i < nbParties; i++)
+	{
+		Controleur c(graine, i);
+		journal.debutPartie(c.sauvegarder());
+		c.setObservateur(&journal);
+		c.distribuer();
+		while (true)
+		{
+			std::vector<Triplet> sets = c.getPlateau().findSets();
+			if (!sets.empty())
+				c.jouer(Combinaison(sets.front()));
+			else if (c.getPioche().estVide())
+				break;
+			c.distribuer();
+		}
+		journal.finPartie();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		cout << "usage : journal generer|verifier|texte|sets <fichier> [nbParties] [graine]\n";
+		return 1;
+	}
+	try
+	{
+		if (std::strcmp(argv[1], "generer") == 0)
+		{
+			size_t nbParties = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000;
+			std::uint64_t graine = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+			generer(argv[2], nbParties, graine);
+		}
+		else if (std::strcmp(argv[1], "verifier") == 0)
+			cout << LecteurJournal(argv[2]).verifier();
+		else if (std::strcmp(argv[1], "texte") == 0)
+			LecteurJournal(argv[2]).convertirEnTexte(cout);
+		else if (std::strcmp(argv[1], "sets") == 0)
+		{
+			TamponCombinaisons sets;
+			LecteurJournal(argv[2]).collecterSets(sets);
+			size_t nbReclames = sets.getTaille();
+			sets.normaliser();
+			cout << "sets reclames : " << nbReclames << " (" << sets.getTaille() << " distincts sur " << NB_SETS_JEU << ")\n";
+		}
+		else
+		{
+			cout << "commande inconnue : " << argv[1] << "\n";
+			return 1;
+		}
+	}
+	catch (SetException &e)
+	{
+		cout << "Exception: " << e.getInfo() << "\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,37 @@
+/**
+ * ============================================================================
+ * 蒙特卡洛模拟命令行工具 (Monte Carlo Simulation Driver)
+ * ============================================================================
+ *
+ * 用法：./simuler [nbParties] [nbThreads] [graine]
+ * - nbThreads 为 0（默认）时使用所有核心
+ *
+ * 编译运行（在 outils 目录下）：
+ *   g++ -std=c++17 -O2 -pthread simuler.cpp ../simulation.cpp ../set.cpp -o simuler && ./simuler 1000000
+ */
+
+#include "../simulation.h"
+#include <cstdlib>
+
+using namespace Set;
+
+int main(int argc, char *argv[])
+{
+	ParametresSimulation p;
+	if (argc > 1)
+		p.nbParties = std::strtoull(argv[1], nullptr, 10);
+	if (argc > 2)
+		p.nbThreads = unsigned(std::strtoul(argv[2], nullptr, 10));
+	if (argc > 3)
+		p.graine = std::strtoull(argv[3], nullptr, 10);
+
+	try
+	{
+		cout << Simulateur(p).lancer();
+	}
+	catch (SetException &e)
+	{
+		cout << "Exception: " << e.getInfo() << "\n";
+	}
+	return 0;
+}
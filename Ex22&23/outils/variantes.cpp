@@ -0,0 +1,77 @@
+/**
+ * ============================================================================
+ * SET 变体演示与性能对比 (Generic Set Engine Demo)
+ * ============================================================================
+ *
+ * 1. 统计各个变体整副牌中的 SET 个数，与理论值对比
+ *    - K = 3：K^N (K^N - 1) / 6
+ *    - projective：C(2^N - 1, 任意) 中异或为 0 的子集个数 = 2^(2^N - 1 - N) - 1
+ * 2. 对比经典游戏走通用模板（Regles<4,3> 特化）与 set.h 中 compterSets 的速度
+ *
+ * 编译运行（在 outils 目录下）：
+ *   g++ -std=c++17 -O2 variantes.cpp ../set.cpp -o variantes && ./variantes
+ */
+
+#include "../setgenerique.h"
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+using namespace Set;
+
+template <size_t N, size_t K>
+static void afficherVariante()
+{
+	using Jeu = JeuGenerique<N, K>;
+	std::vector<typename Jeu::Id> ids;
+	for (const auto &c : Jeu::getInstance())
+		ids.push_back(c.getId());
+	size_t nb = compterSetsGenerique<N, K>(ids.data(), ids.size());
+	cout << "N=" << N << " K=" << K << " : " << Jeu::getNbCartes() << " cartes, "
+		 << nb << " sets";
+	if (K == 3)
+		cout << " (theorie " << Jeu::getNbCartes() * (Jeu::getNbCartes() - 1) / 6 << ")";
+	cout << "\n";
+}
+
+int main()
+{
+	afficherVariante<3, 3>();
+	afficherVariante<4, 3>();
+	afficherVariante<5, 3>();
+	afficherVariante<3, 4>();
+
+	// projective SET à 6 couleurs : 63 cartes
+	using Proj = EspaceProjectif<6>;
+	std::vector<Proj::Id> proj;
+	for (size_t i = 1; i <= Proj::NB_CARTES; i++)
+		proj.push_back(Proj::Id(i));
+	cout << "projectif N=6 : " << Proj::NB_CARTES << " cartes, plateau de 7 cartes : "
+		 << Proj::compterSets(proj.data(), 7) << " sets\n";
+
+	// 经典游戏：通用模板 vs set.h 专用实现
+	std::mt19937 rng(7);
+	std::vector<CarteId> ordre(config::NB_CARTES);
+	for (size_t i = 0; i < ordre.size(); i++)
+		ordre[i] = CarteId(i);
+	std::vector<std::vector<CarteId>> plateaux(20000);
+	for (auto &p : plateaux)
+	{
+		std::shuffle(ordre.begin(), ordre.end(), rng);
+		p.assign(ordre.begin(), ordre.begin() + 12);
+	}
+
+	size_t a = 0, b = 0;
+	auto t0 = std::chrono::steady_clock::now();
+	for (const auto &p : plateaux)
+		a += compterSets(p.data(), p.size());
+	auto t1 = std::chrono::steady_clock::now();
+	for (const auto &p : plateaux)
+		b += compterSetsGenerique<4, 3>(p.data(), p.size());
+	auto t2 = std::chrono::steady_clock::now();
+	cout << "classique : compterSets " << std::chrono::duration<double, std::nano>(t1 - t0).count() / plateaux.size()
+		 << " ns/plateau, compterSetsGenerique<4,3> " << std::chrono::duration<double, std::nano>(t2 - t1).count() / plateaux.size()
+		 << " ns/plateau" << (a == b ? "" : "  [RESULTATS DIFFERENTS !]") << "\n";
+	return 0;
+}
@@ -0,0 +1,241 @@
+/**
+ * ============================================================================
+ * 多桌并发对局引擎实现文件 (Concurrent Multi-table Game Engine Implementation)
+ * ============================================================================
+ */
+
+#include "serveur.h"
+#include <algorithm>
+#include <chrono>
+
+namespace Set
+{
+	Table::Table(std::uint64_t graine, std::uint64_t flux, size_t n)
+		: nbPioche(config::NB_CARTES), generateur(graine, flux), nbJoueurs(n)
+	{
+		if (nbJoueurs == 0 || nbJoueurs > MAX_JOUEURS)
+			throw SetException("Table : nombre de joueurs invalide");
+		for (size_t i = 0; i < config::NB_CARTES; i++)
+			pioche[i] = CarteId(i);
+		for (std::atomic<std::uint32_t> &s : scores)
+			s.store(0, std::memory_order_relaxed);
+
+		MasqueCartes plateau;
+		distribuer(plateau);
+		mots[0].store(plateau.mots[0], std::memory_order_relaxed);
+		mots[1].store(plateau.mots[1], std::memory_order_relaxed);
+	}
+
+	void Table::distribuer(MasqueCartes &plateau)
+	{
+		auto piocher = [&]()
+		{
+			size_t i = generateur.borne(nbPioche);
+			plateau.ajouter(pioche[i]);
+			pioche[i] = pioche[--nbPioche];
+		};
+		auto aUnSet = [&]()
+		{
+			CarteId ids[config::NB_CARTES];
+			size_t n = 0;
+			plateau.pourChaque([&](CarteId id)
+							   { ids[n++] = id; });
+			return contientSet(ids, n);
+		};
+
+		do
+		{
+			if (nbPioche > 0)
+				piocher();
+			while (nbPioche > 0 && plateau.getNbCartes() < config::PLATEAU_MIN_CARTES)
+				piocher();
+		} while (nbPioche > 0 && !aUnSet());
+
+		if (nbPioche == 0 && !aUnSet())
+			terminee.store(true, std::memory_order_release);
+	}
+
+	MasqueCartes Table::lire() const
+	{
+		MasqueCartes m;
+		while (true)
+		{
+			std::uint64_t e1 = epoque.load(std::memory_order_acquire);
+			if (e1 & 1)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			m.mots[0] = mots[0].load(std::memory_order_relaxed);
+			m.mots[1] = mots[1].load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (epoque.load(std::memory_order_relaxed) == e1)
+				return m;
+		}
+	}
+
+	Reclamation Table::reclamer(size_t joueur, const Triplet &t)
+	{
+		if (joueur >= nbJoueurs)
+			throw SetException("Table : joueur inexistant");
+		if (t.a == t.b || t.a == t.c || t.b == t.c || !estUnSet(t.a, t.b, t.c))
+			return Reclamation::invalide;
+
+		std::uint64_t e;
+		MasqueCartes plateau;
+		while (true)
+		{
+			e = epoque.load(std::memory_order_acquire);
+			if (e & 1)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			plateau.mots[0] = mots[0].load(std::memory_order_relaxed);
+			plateau.mots[1] = mots[1].load(std::memory_order_relaxed);
+			if (!plateau.contient(t.a) || !plateau.contient(t.b) || !plateau.contient(t.c))
+			{
+				// 读到的桌面可能不一致：只有 epoque 没变时，"已被拿走"才是确定的结论
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (epoque.load(std::memory_order_relaxed) == e)
+					return Reclamation::dejaPrise;
+				continue;
+			}
+			// 仲裁点：CAS 成功说明从读 epoque 到现在没有人修改过桌面，这次提交获胜
+			if (epoque.compare_exchange_weak(e, e + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+				break;
+			nbConflits.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// 获胜者独占修改（epoque 为奇数，其它线程只会自旋或重试）
+		std::atomic_thread_fence(std::memory_order_release);
+		plateau.retirer(t.a);
+		plateau.retirer(t.b);
+		plateau.retirer(t.c);
+		distribuer(plateau);
+		mots[0].store(plateau.mots[0], std::memory_order_relaxed);
+		mots[1].store(plateau.mots[1], std::memory_order_relaxed);
+		scores[joueur].fetch_add(1, std::memory_order_relaxed);
+		epoque.store(e + 2, std::memory_order_release);
+		return Reclamation::acceptee;
+	}
+
+	ServeurTables::ServeurTables(const ParametresServeur &p) : parametres(p)
+	{
+		if (parametres.nbJoueurs == 0 || parametres.nbJoueurs > Table::MAX_JOUEURS)
+			throw SetException("ServeurTables : nombre de joueurs invalide");
+	}
+
+	namespace
+	{
+		/**
+		 * Bot: 任务 = 第 table 张桌子的第 joueur 个机器人出手一次
+		 */
+		struct Bot
+		{
+			std::uint32_t table;
+			std::uint8_t joueur;
+		};
+
+		/**
+		 * CompteursThread: 每个线程自己的计数和延迟样本，最后再合并
+		 */
+		struct CompteursThread
+		{
+			size_t nbReclamations = 0;
+			size_t nbAcceptees = 0;
+			size_t nbDejaPrises = 0;
+			std::vector<std::uint32_t> latences; // 纳秒
+		};
+	}
+
+	StatistiquesServeur ServeurTables::lancer() const
+	{
+		std::unique_ptr<std::unique_ptr<Table>[]> tables(new std::unique_ptr<Table>[parametres.nbTables]);
+		for (size_t i = 0; i < parametres.nbTables; i++)
+			tables[i].reset(new Table(parametres.graine, i, parametres.nbJoueurs));
+
+		Executeur<Bot> executeur(parametres.nbThreads);
+		unsigned nbThreads = executeur.getNbThreads();
+		std::vector<CompteursThread> compteurs(nbThreads);
+		std::vector<GenerateurAleatoire> generateurs;
+		for (unsigned t = 0; t < nbThreads; t++)
+			generateurs.emplace_back(parametres.graine ^ 0x5bd1e995u, t);
+
+		// 同一张桌子的机器人分到不同线程的队列里，让它们真正同时出手
+		size_t k = 0;
+		for (size_t i = 0; i < parametres.nbTables; i++)
+			for (size_t j = 0; j < parametres.nbJoueurs; j++)
+				executeur.ajouter(Bot{std::uint32_t(i), std::uint8_t(j)}, unsigned(k++));
+
+		auto debut = std::chrono::steady_clock::now();
+		executeur.executer([&](const Bot &bot, unsigned t)
+						   {
+			Table &table = *tables[bot.table];
+			if (table.estTerminee())
+				return;
+
+			MasqueCartes plateau = table.lire();
+			CarteId ids[config::NB_CARTES];
+			size_t n = 0;
+			plateau.pourChaque([&](CarteId id)
+							   { ids[n++] = id; });
+			std::vector<Triplet> sets = trouverSets(ids, n);
+			if (!sets.empty())
+			{
+				const Triplet &choix = sets[generateurs[t].borne(std::uint32_t(sets.size()))];
+				auto t0 = std::chrono::steady_clock::now();
+				Reclamation r = table.reclamer(bot.joueur, choix);
+				auto t1 = std::chrono::steady_clock::now();
+
+				CompteursThread &c = compteurs[t];
+				c.nbReclamations++;
+				c.nbAcceptees += r == Reclamation::acceptee;
+				c.nbDejaPrises += r == Reclamation::dejaPrise;
+				c.latences.push_back(std::uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+			}
+			if (!table.estTerminee())
+				executeur.ajouter(bot, t); });
+		auto fin = std::chrono::steady_clock::now();
+
+		StatistiquesServeur s;
+		s.nbTables = parametres.nbTables;
+		s.nbVols = executeur.getNbVols();
+		s.dureeSecondes = std::chrono::duration<double>(fin - debut).count();
+		std::vector<std::uint32_t> latences;
+		for (const CompteursThread &c : compteurs)
+		{
+			s.nbReclamations += c.nbReclamations;
+			s.nbAcceptees += c.nbAcceptees;
+			s.nbDejaPrises += c.nbDejaPrises;
+			latences.insert(latences.end(), c.latences.begin(), c.latences.end());
+		}
+		for (size_t i = 0; i < parametres.nbTables; i++)
+			s.nbConflits += tables[i]->getNbConflits();
+		if (!latences.empty())
+		{
+			auto quantile = [&](double q)
+			{
+				size_t i = std::min(latences.size() - 1, size_t(q * latences.size()));
+				std::nth_element(latences.begin(), latences.begin() + i, latences.end());
+				return double(latences[i]);
+			};
+			s.latenceMedianeNs = quantile(0.5);
+			s.latenceP99Ns = quantile(0.99);
+		}
+		return s;
+	}
+
+	ostream &operator<<(ostream &f, const StatistiquesServeur &s)
+	{
+		f << "tables                : " << s.nbTables << "\n";
+		f << "reclamations          : " << s.nbReclamations << " (" << s.nbAcceptees << " acceptees, "
+		  << s.nbDejaPrises << " deja prises, " << s.nbConflits << " conflits CAS)\n";
+		f << "debit                 : " << s.reclamationsParSeconde() << " reclamations/s ("
+		  << s.dureeSecondes << " s)\n";
+		f << "latence reclamation   : p50 " << s.latenceMedianeNs << " ns, p99 " << s.latenceP99Ns << " ns\n";
+		f << "taches volees         : " << s.nbVols << "\n";
+		return f;
+	}
+
+} // end of namespace Set
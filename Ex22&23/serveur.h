@@ -0,0 +1,245 @@
+#ifndef _SERVEUR_H
+#define _SERVEUR_H
+
+#include "set.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * ============================================================================
+ * 多桌并发对局引擎 (Concurrent Multi-table Game Engine)
+ * ============================================================================
+ *
+ * 目标：一个进程同时运行成千上万张牌桌，每张桌子有若干个机器人玩家，
+ * 多个玩家可能同时对同一张桌子提交 SET，第一个合法的提交必须原子地获胜，
+ * 且不使用全局锁。
+ *
+ * Table 的并发设计：
+ * - 桌面是 81 位集合，存在两个 std::atomic<uint64_t> 中
+ * - epoque 是版本号（seqlock）：偶数表示稳定，奇数表示获胜者正在修改桌面
+ * - 读桌面：读 epoque -> 读两个字 -> 再读 epoque，两次相同且为偶数才算一致的快照
+ * - 提交 SET（仲裁）：
+ *   1. 读 epoque（偶数）和桌面，检查三张卡都在桌面上
+ *   2. CAS epoque: e -> e + 1，成功者即为获胜者；失败说明桌面刚被别人改过，重新检查
+ *   3. 获胜者移走三张卡、补牌，然后 epoque = e + 2 发布新桌面
+ * - 每张桌子的牌堆和随机数生成器只由获胜者在第 3 步中访问，不需要额外同步
+ * - 不同桌子之间没有任何共享状态
+ *
+ * Executeur：工作窃取 (work stealing) 线程池
+ * - 每个线程一个任务队列：自己从头部取，别的线程从尾部偷
+ * - 一个任务 = 某张桌子的某个机器人出手一次；没结束的桌子把任务重新放回队列
+ */
+namespace Set
+{
+	/**
+	 * Reclamation: 一次提交的结果
+	 * - acceptee: 获胜，三张卡被移走
+	 * - dejaPrise: 合法的 SET，但至少一张卡已经被别人拿走
+	 * - invalide: 三张卡不构成 SET
+	 */
+	enum class Reclamation
+	{
+		acceptee,
+		dejaPrise,
+		invalide
+	};
+
+	/**
+	 * Table: 一张牌桌（规则与 Controleur 相同）
+	 */
+	class Table
+	{
+	public:
+		static constexpr size_t MAX_JOUEURS = 8;
+
+	private:
+		// 多线程共享的状态
+		std::atomic<std::uint64_t> epoque{0};
+		std::atomic<std::uint64_t> mots[2];
+		std::atomic<bool> terminee{false};
+		std::atomic<std::uint32_t> scores[MAX_JOUEURS];
+		std::atomic<std::uint64_t> nbConflits{0}; // CAS 失败的次数
+
+		// 只有获胜者（持有奇数 epoque 时）访问的状态
+		CarteId pioche[config::NB_CARTES];
+		std::uint8_t nbPioche;
+		GenerateurAleatoire generateur;
+		size_t nbJoueurs;
+
+		/**
+		 * distribuer: 与 Controleur::distribuer() 相同的规则，
+		 * 然后只要桌面上没有 SET 且牌堆不空就继续发牌；发完仍没有 SET 则对局结束
+		 */
+		void distribuer(MasqueCartes &plateau);
+
+	public:
+		Table(std::uint64_t graine, std::uint64_t flux, size_t nbJoueurs);
+		Table(const Table &) = delete;
+		Table &operator=(const Table &) = delete;
+
+		/**
+		 * lire: 读取一致的桌面快照（seqlock，不加锁；获胜者修改期间自旋等待）
+		 */
+		MasqueCartes lire() const;
+
+		/**
+		 * reclamer: 玩家 joueur 提交 SET t
+		 * 多个线程同时提交时，第一个合法的提交获胜，其余得到 dejaPrise
+		 * 异常：joueur 超出范围时抛出 SetException
+		 */
+		Reclamation reclamer(size_t joueur, const Triplet &t);
+
+		bool estTerminee() const { return terminee.load(std::memory_order_acquire); }
+		size_t getNbJoueurs() const { return nbJoueurs; }
+		std::uint32_t getScore(size_t joueur) const { return scores[joueur].load(std::memory_order_relaxed); }
+		std::uint64_t getNbConflits() const { return nbConflits.load(std::memory_order_relaxed); }
+	};
+
+	/**
+	 * Executeur: 工作窃取线程池
+	 *
+	 * 用法：先 ajouter() 初始任务，再 executer(traiter)；
+	 * traiter(tache, numeroThread) 可以再调用 ajouter(tache, numeroThread) 产生新任务，
+	 * 所有任务（包括新产生的）处理完后 executer 返回
+	 */
+	template <typename Tache>
+	class Executeur
+	{
+	private:
+		struct File
+		{
+			std::mutex verrou;
+			std::deque<Tache> taches;
+		};
+		unsigned nbThreads;
+		std::unique_ptr<File[]> files;
+		std::atomic<size_t> nbEnAttente{0}; // 已加入但还没处理完的任务数
+		std::atomic<size_t> nbVols{0};
+
+		bool prendre(unsigned t, Tache &tache)
+		{
+			std::lock_guard<std::mutex> v(files[t].verrou);
+			if (files[t].taches.empty())
+				return false;
+			tache = files[t].taches.front();
+			files[t].taches.pop_front();
+			return true;
+		}
+		bool voler(unsigned t, Tache &tache)
+		{
+			std::lock_guard<std::mutex> v(files[t].verrou);
+			if (files[t].taches.empty())
+				return false;
+			tache = files[t].taches.back();
+			files[t].taches.pop_back();
+			return true;
+		}
+
+	public:
+		explicit Executeur(unsigned n)
+			: nbThreads(n ? n : std::max(1u, std::thread::hardware_concurrency())),
+			  files(new File[nbThreads]) {}
+
+		unsigned getNbThreads() const { return nbThreads; }
+		size_t getNbVols() const { return nbVols.load(); }
+
+		void ajouter(const Tache &tache, unsigned t)
+		{
+			nbEnAttente.fetch_add(1, std::memory_order_relaxed);
+			std::lock_guard<std::mutex> v(files[t % nbThreads].verrou);
+			files[t % nbThreads].taches.push_back(tache);
+		}
+
+		template <typename F>
+		void executer(F traiter)
+		{
+			std::vector<std::thread> threads;
+			for (unsigned t = 0; t < nbThreads; t++)
+				threads.emplace_back([this, t, &traiter]()
+									 {
+					Tache tache;
+					while (nbEnAttente.load(std::memory_order_acquire) != 0)
+					{
+						bool trouve = prendre(t, tache);
+						for (unsigned i = 1; !trouve && i < nbThreads; i++)
+							if (voler((t + i) % nbThreads, tache))
+							{
+								trouve = true;
+								nbVols.fetch_add(1, std::memory_order_relaxed);
+							}
+						if (!trouve)
+						{
+							std::this_thread::yield();
+							continue;
+						}
+						traiter(tache, t);
+						nbEnAttente.fetch_sub(1, std::memory_order_acq_rel);
+					} });
+			for (std::thread &th : threads)
+				th.join();
+		}
+	};
+
+	/**
+	 * ParametresServeur: 负载生成参数
+	 * - nbThreads == 0 表示使用所有核心
+	 */
+	struct ParametresServeur
+	{
+		size_t nbTables = 1000;
+		size_t nbJoueurs = 4;
+		unsigned nbThreads = 0;
+		std::uint64_t graine = 1;
+	};
+
+	/**
+	 * StatistiquesServeur: 负载测试结果
+	 */
+	struct StatistiquesServeur
+	{
+		size_t nbTables = 0;
+		size_t nbReclamations = 0;
+		size_t nbAcceptees = 0;
+		size_t nbDejaPrises = 0;
+		size_t nbConflits = 0; // CAS 失败后重试的次数
+		size_t nbVols = 0;	   // 被其它线程偷走的任务数
+		double latenceMedianeNs = 0;
+		double latenceP99Ns = 0;
+		double dureeSecondes = 0;
+
+		double reclamationsParSeconde() const { return dureeSecondes > 0 ? nbReclamations / dureeSecondes : 0; }
+	};
+
+	/**
+	 * ServeurTables: 本地负载生成器
+	 * 每个机器人看一眼桌面，随机选一个 SET 提交；同一张桌子的机器人互相竞争
+	 *
+	 * 使用示例：
+	 *   ParametresServeur p;
+	 *   p.nbTables = 10000;
+	 *   cout << ServeurTables(p).lancer();
+	 */
+	class ServeurTables
+	{
+	private:
+		ParametresServeur parametres;
+
+	public:
+		explicit ServeurTables(const ParametresServeur &p);
+
+		/**
+		 * lancer: 运行所有桌子直到全部结束，返回吞吐量和延迟统计
+		 */
+		StatistiquesServeur lancer() const;
+	};
+
+	ostream &operator<<(ostream &f, const StatistiquesServeur &s);
+
+} // end of namespace Set
+
+#endif // _SERVEUR_H
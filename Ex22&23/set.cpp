@@ -13,10 +13,16 @@
  */
 
 #include "set.h"
-#include <cstdlib> // 提供 rand() 函数用于随机抽牌
+#include <algorithm> // std::min, std::sort, std::inplace_merge
+#include <utility>   // std::swap
 
 namespace Set
 {
+	void echecVerification(const char *message)
+	{
+		throw SetException(message);
+	}
+
 	// ========================================================================
 	// 全局常量列表定义 (Global Constant Lists Definition)
 	// ========================================================================
@@ -39,86 +45,19 @@ namespace Set
 	std::initializer_list<Forme> Formes = {Forme::ovale, Forme::vague, Forme::losange};
 	std::initializer_list<Remplissage> Remplissages = {Remplissage::plein, Remplissage::vide, Remplissage::hachure};
 
-	string toString(Couleur c)
-	{
-		switch (c)
-		{
-		case Couleur::rouge:
-			return "R";
-		case Couleur::mauve:
-			return "M";
-		case Couleur::vert:
-			return "V";
-		default:
-			throw SetException("Couleur inconnue");
-		}
-	}
-
-	string toString(Nombre v)
-	{
-		switch (v)
-		{
-		case Nombre::un:
-			return "1";
-		case Nombre::deux:
-			return "2";
-		case Nombre::trois:
-			return "3";
-		default:
-			throw SetException("Nombre inconnue");
-		}
-	}
-
-	string toString(Forme f)
-	{
-		switch (f)
-		{
-		case Forme::ovale:
-			return "O";
-		case Forme::vague:
-			return "~";
-		case Forme::losange:
-			return "\004";
-		default:
-			throw SetException("Forme inconnue");
-		}
-	}
-
-	string toString(Remplissage r)
-	{
-		switch (r)
-		{
-		case Remplissage::plein:
-			return "P";
-		case Remplissage::vide:
-			return "_";
-		case Remplissage::hachure:
-			return "H";
-		default:
-			throw SetException("Remplissage inconnu");
-		}
-	}
+	/**
+	 * toString / operator<<：基于 set.h 中的静态字形表
+	 * operator<< 直接输出 string_view，不再为每个特征构造 string
+	 */
+	string toString(Couleur c) { return string(glyphe(c)); }
+	string toString(Nombre v) { return string(glyphe(v)); }
+	string toString(Forme f) { return string(glyphe(f)); }
+	string toString(Remplissage r) { return string(glyphe(r)); }
 
-	std::ostream &operator<<(std::ostream &f, Couleur c)
-	{
-		f << toString(c);
-		return f;
-	}
-	std::ostream &operator<<(std::ostream &f, Nombre v)
-	{
-		f << toString(v);
-		return f;
-	}
-	std::ostream &operator<<(std::ostream &f, Forme x)
-	{
-		f << toString(x);
-		return f;
-	}
-	std::ostream &operator<<(std::ostream &f, Remplissage r)
-	{
-		f << toString(r);
-		return f;
-	}
+	std::ostream &operator<<(std::ostream &f, Couleur c) { return f << glyphe(c); }
+	std::ostream &operator<<(std::ostream &f, Nombre v) { return f << glyphe(v); }
+	std::ostream &operator<<(std::ostream &f, Forme x) { return f << glyphe(x); }
+	std::ostream &operator<<(std::ostream &f, Remplissage r) { return f << glyphe(r); }
 
 	void printCouleurs(std::ostream &f)
 	{
@@ -150,278 +89,174 @@ namespace Set
 
 	ostream &operator<<(ostream &f, const Carte &c)
 	{
-		f << "[" << c.getCouleur() << c.getForme()
-		  << c.getNombre() << c.getRemplissage() << "]";
-		return f;
-	}
-
-	Jeu::Jeu()
-	{
-		size_t i = 0;
-		for (auto c : Couleurs) // 遍历枚举，相当于JS的 for(let c of Couleurs)
-			for (auto n : Nombres)
-				for (auto f : Formes)
-					for (auto r : Remplissages)
-						cartes[i++] = new Carte(c, n, f, r);
-	}
-
-	const Carte &Jeu::getCarte(size_t i) const
-	{
-		if (i >= 81)
-			throw SetException("carte iexistante");
-		return *cartes[i];
+		return f.write(TEXTES_CARTES[c.getId()].data(), TAILLE_TEXTE_CARTE);
 	}
 
-	Jeu::~Jeu()
-	{
-		for (size_t i = 0; i < 81; i++)
-			delete cartes[i];
-	}
+	/**
+	 * Jeu::cartes 的定义：整个数组由 constexpr 的 genererCartes() 生成
+	 * 初始化表达式是常量表达式，因此是常量初始化（编译期完成，无运行时构造，
+	 * 相当于 C++20 的 constinit），不存在静态初始化顺序问题
+	 */
+	const std::array<Carte, config::NB_CARTES> Jeu::cartes =
+		Jeu::genererCartes(std::make_index_sequence<config::NB_CARTES>{});
 
 	const Carte &Pioche::piocher()
 	{ // get a random carte from the pioche
 		// test if the pioche is not empty
-		if (estVide())
-			throw SetException("empty pioche");
-		// choose a carte
-		size_t i = rand() % nb; // get a random number between 0 and nb
+		verifier(!estVide(), "empty pioche");
+		// melangee: the pioche is already shuffled, just take the last carte
+		if (mode == ModeTirage::melangee)
+		{
+			masque.retirer(cartes[nb - 1]->getId());
+			return *cartes[--nb];
+		}
+		// choose a carte (uniform, no modulo bias)
+		size_t i = generateur.borne(std::uint32_t(nb)); // get a random number between 0 and nb
 		const Carte *chosenCarte = cartes[i];
-		// remove the card from the array
-		cartes[i] = cartes[nb - 1]; // replace carte i by the last carte of the pioche
+		// swap it with the last carte of the pioche, so that drawn cartes stay at the end
+		cartes[i] = cartes[nb - 1];
+		cartes[nb - 1] = chosenCarte;
 		nb--;
+		masque.retirer(chosenCarte->getId());
 		return *chosenCarte; // returns a reference over the chosen carte
 	}
 
-	/**
-	 * 向游戏台添加一张卡牌 (Add a card to the plateau)
-	 *
-	 * @param c 要添加的卡牌的常量引用
-	 *
-	 * 实现要点：
-	 * 1. 动态扩容机制
-	 *    - 当数组满时，自动扩容（增加 5 个位置）
-	 *    - 将旧数组内容复制到新数组
-	 *    - 释放旧数组内存
-	 *
-	 * 2. 为什么存储指针而不是对象？
-	 *    - 卡牌对象由 Jeu 类管理（81 张固定卡牌）
-	 *    - 避免重复创建和销毁卡牌对象
-	 *    - 节省内存，提高性能
-	 *
-	 * 3. 扩容步长为什么是 5？
-	 *    - 平衡内存使用和分配次数
-	 *    - SET 游戏通常每次添加 3 张牌
-	 *    - 5 是合理的小步长
-	 */
-	void Plateau::ajouter(const Carte &c)
+	void Pioche::piocherN(size_t k, const Carte **sortie)
 	{
-		// 检查数组是否已满
-		if (nb == nbMax)
+		if (k > nb)
+			throw SetException("not enough cartes in pioche");
+		if (mode == ModeTirage::melangee)
 		{
-			// 数组所有位置都已使用，需要扩容
-
-			// 创建一个更大的数组（增加 5 个位置）
-			const Carte **newarray = new const Carte *[nbMax + 5];
-
-			// 将所有卡牌的地址复制到新数组
-			for (size_t i = 0; i < nb; i++)
-				newarray[i] = cartes[i];
-
-			// 保存旧数组的指针以便后续释放
-			const Carte **old = cartes;
-
-			// 将新数组设置为当前使用的数组
-			cartes = newarray;
-
-			// 更新最大容量
-			nbMax += 5;
-
-			// 释放旧数组的内存（注意：只释放数组本身，不释放卡牌对象）
-			delete[] old;
+			// 已洗好的牌：末尾 k 张就是接下来要抽的牌
+			for (size_t i = 0; i < k; i++)
+			{
+				sortie[i] = cartes[nb - 1 - i];
+				masque.retirer(sortie[i]->getId());
+			}
+			nb -= k;
+			return;
+		}
+		for (size_t i = 0; i < k; i++)
+		{
+			size_t j = generateur.borne(std::uint32_t(nb));
+			sortie[i] = cartes[j];
+			cartes[j] = cartes[nb - 1];
+			cartes[nb - 1] = sortie[i];
+			nb--;
+			masque.retirer(sortie[i]->getId());
 		}
-
-		// 现在可以确定有足够的空间来存储更多卡牌
-		// 将新卡牌的地址存储到数组末尾
-		cartes[nb] = &c;
-
-		// 增加已存储卡牌的数量
-		nb++;
 	}
 
-	/**
-	 * 从游戏台移除一张卡牌 (Remove a card from the plateau)
-	 *
-	 * @param c 要移除的卡牌的常量引用
-	 * @throws SetException 如果卡牌不存在于游戏台
-	 *
-	 * 实现策略：
-	 * 1. 线性搜索要移除的卡牌（比较指针地址）
-	 * 2. 用最后一张卡牌替换要移除的卡牌（避免移动大量元素）
-	 * 3. 减少卡牌计数
-	 *
-	 * 时间复杂度：O(n) - 需要搜索卡牌
-	 * 优点：移除操作本身是 O(1)
-	 * 缺点：不保持卡牌顺序（但 SET 游戏不需要保持顺序）
-	 */
-	void Plateau::retirer(const Carte &c)
+	EtatPioche Pioche::getEtat() const
 	{
-		// 在数组中搜索要移除的卡牌
-		size_t i = 0;
-		while (i < nb && cartes[i] != &c) // 比较指针地址
-			i++;
-
-		// 如果遍历完整个数组都没找到，说明卡牌不存在
-		if (i == nb)
-			throw SetException("this card does not exist");
+		EtatPioche e;
+		for (size_t i = 0; i < nb; i++)
+			e.ordre[i] = cartes[i]->getId();
+		e.nb = std::uint8_t(nb);
+		e.generateur = generateur;
+		return e;
+	}
 
-		// 用最后一张卡牌替换要移除的卡牌（高效的移除方法）
-		cartes[i] = cartes[nb - 1];
+	void Pioche::setEtat(const EtatPioche &e)
+	{
+		// 编号即 Jeu 中的下标
+		const Jeu &jeu = Jeu::getInstance();
+		masque = MasqueCartes();
+		for (size_t i = 0; i < e.nb; i++)
+		{
+			cartes[i] = &jeu.getCarte(e.ordre[i]);
+			masque.ajouter(e.ordre[i]);
+		}
+		nb = e.nb;
+		generateur = e.generateur;
+	}
 
-		// 减少卡牌计数（原来的最后一张卡牌现在不再有效）
-		nb--;
+	void Pioche::melanger()
+	{
+		// Fisher-Yates：从后往前，每个位置与前面随机一个位置交换
+		for (size_t i = nb; i > 1; i--)
+		{
+			size_t j = generateur.borne(std::uint32_t(i));
+			std::swap(cartes[i - 1], cartes[j]);
+		}
 	}
 
 	/**
-	 * 拷贝构造函数 (Copy Constructor)
+	 * 向游戏台添加一张卡牌 (Add a card to the plateau)
 	 *
-	 * @param p 要拷贝的源 Plateau 对象
+	 * @param id 要添加的卡牌编号
+	 * @throws SetException 卡牌已在游戏台上，或游戏台已满
 	 *
-	 * 为什么需要自定义拷贝构造函数？
-	 * =====================================
-	 * 如果使用默认拷贝构造函数（编译器自动生成）：
-	 * - 会执行浅拷贝：只复制指针 cartes 的值
-	 * - 结果：两个 Plateau 对象的 cartes 指向同一个数组
-	 * - 问题：修改一个对象会影响另一个对象
-	 * - 更严重：析构时会导致双重释放（double free）错误
+	 * 实现要点：
+	 * 1. 固定容量，不扩容
+	 *    - 最多 PLATEAU_MAX_CARTES 张，数组存放在对象内部
+	 *    - 满了说明调用者在有 SET 时还在加牌（见 config::PLATEAU_MAX_CARTES）
 	 *
-	 * 深拷贝实现：
-	 * ===========
-	 * 1. 为新对象分配独立的数组
-	 * 2. 复制所有卡牌指针（注意：复制的是指针，不是卡牌对象）
-	 * 3. 复制容量和大小信息
+	 * 2. 为什么存储编号而不是指针？
+	 *    - 卡牌对象由 Jeu 类管理（81 张固定卡牌），按编号即可取回
+	 *    - 编号只占 1 字节，整个 Plateau 没有指针成员，可以直接按字节拷贝
 	 *
-	 * 结果：每个 Plateau 有自己的数组，但指向相同的卡牌对象
+	 * 3. position[id] 记录卡牌的位置，retirer 时不需要搜索
 	 */
-	Plateau::Plateau(const Plateau &p)
+	void Plateau::ajouter(CarteId id)
 	{
-		// 为新 Plateau 分配独立的数组（深拷贝）
-		cartes = new const Carte *[p.nbMax];
-
-		// 复制源对象的容量和大小信息
-		nb = p.nb;
-		nbMax = p.nbMax;
-
-		// 复制所有卡牌指针
-		for (size_t i = 0; i < p.nb; i++)
-			cartes[i] = p.cartes[i];
-
-		// 现在每个 Plateau 都有自己的数组，但包含相同的卡牌
+		if (masque.contient(id))
+			throw SetException("this card is already on the plateau");
+		if (nb == config::PLATEAU_MAX_CARTES)
+			throw SetException("plateau plein (PLATEAU_MAX_CARTES) : on n'ajoute une carte que si le plateau n'a pas de SET");
+
+		// 新增的 SET：包含 id 且另外两张已在桌面上的那些
+		nbSets = std::uint8_t(nbSets + compterSetsAvec(id));
+
+		// 放到数组末尾，并记录位置
+		position[id] = nb;
+		cartes[nb++] = id;
+		masque.ajouter(id);
 	}
 
 	/**
-	 * 赋值运算符重载 (Assignment Operator)
+	 * compterSetsAvec: 桌面上包含 id 的 SET 个数（id 本身不在桌面上）
 	 *
-	 * @param p 要赋值的源 Plateau 对象
-	 * @return 返回当前对象的引用（支持链式赋值）
-	 *
-	 * 实现要点：
-	 * =========
-	 * 1. 自赋值检查：if (this != &p)
-	 *    - 防止 a = a 这样的操作导致问题
-	 *    - 提高性能（避免不必要的操作）
-	 *
-	 * 2. 赋值策略：
-	 *    - 清空当前 Plateau（设置 nb = 0）
-	 *    - 保留现有数组容量（避免重新分配）
-	 *    - 使用 ajouter() 逐个添加卡牌
-	 *    - ajouter() 会在需要时自动扩容
-	 *
-	 * 3. 为什么不直接复制数组？
-	 *    - 利用现有的 ajouter() 逻辑
-	 *    - 自动处理扩容
-	 *    - 代码复用，减少错误
-	 *
-	 * 4. 返回 *this 的作用：
-	 *    - 支持链式赋值：a = b = c
-	 *    - 符合 C++ 赋值运算符的惯例
+	 * 对桌面上的每张卡 x 查表得到 troisieme(id, x)，在场就说明 {id, x, 第三张} 是 SET。
+	 * 每个 SET 会被它的两张桌面卡各数一次，所以除以 2。
+	 * 只遍历桌面上的 nb 张卡（通常 12 张），比遍历包含 id 的全部 40 个 SET 少一半以上的查表
 	 */
-	Plateau &Plateau::operator=(const Plateau &p)
+	size_t Plateau::compterSetsAvec(CarteId id) const
 	{
-		// 检查是否为自赋值（a = a）
-		if (this != &p)
-		{
-			// 注意：此时 *this 和 p 都有各自的数组
-
-			// 清空当前数组（但保留容量）
-			nb = 0;
-			// 我们认为数组中不再有卡牌
-			// 但保留数组的容量，可以继续存储新的指针
-
-			// 从源对象复制所有卡牌
-			for (size_t i = 0; i < p.nb; i++)
-				ajouter(*p.cartes[i]); // 添加 p 中的每张卡牌
-									   // 如果需要，ajouter 会自动扩容
-		}
-
-		// 返回当前对象的引用（支持链式赋值）
-		return *this;
+		size_t n = 0;
+		for (size_t i = 0; i < nb; i++)
+			n += masque.contient(troisieme(id, cartes[i]));
+		return n / 2;
 	}
 
 	/**
-	 * 判断三张卡牌是否构成一个 SET (Check if three cards form a SET)
-	 *
-	 * @return true 如果三张卡牌构成 SET，false 否则
-	 *
-	 * SET 游戏规则：
-	 * =============
-	 * 三张卡牌构成一个 SET 当且仅当：
-	 * 对于每个特征（颜色、形状、数量、填充），这三张卡牌要么：
-	 * - 完全相同（3 张都一样）
-	 * - 完全不同（3 张都不一样）
-	 *
-	 * 示例：
-	 * ------
-	 * ✓ 合法 SET：[R◇1P] [M◇2P] [V◇3P]
-	 *   - 颜色：R, M, V（全不同）✓
-	 *   - 形状：◇, ◇, ◇（全相同）✓
-	 *   - 数量：1, 2, 3（全不同）✓
-	 *   - 填充：P, P, P（全相同）✓
+	 * 从游戏台移除一张卡牌 (Remove a card from the plateau)
 	 *
-	 * ✗ 非法组合：[R◇1P] [R◇2P] [V◇3P]
-	 *   - 颜色：R, R, V（两同一异）✗
+	 * @param id 要移除的卡牌编号
+	 * @throws SetException 如果卡牌不存在于游戏台
 	 *
-	 * 实现逻辑：
-	 * =========
-	 * 对于每个特征，检查：
-	 * - 条件1：c1 == c2 && c1 == c3  （全相同）
-	 * - 条件2：c1 != c2 && c1 != c3 && c2 != c3  （全不同）
+	 * 实现策略：
+	 * 1. 通过 position 直接找到卡牌的位置（不需要搜索）
+	 * 2. 用最后一张卡牌替换要移除的卡牌（避免移动大量元素）
+	 * 3. 减少卡牌计数
 	 *
-	 * 原先代码中好像最后一个写错了
-	 * 当前条件2写的是：c1 != c2 && c1 != c3 && c2 == c3
-	 * 这实际上允许"两同一异"的情况，违反了 SET 规则
-	 * 正确的应该是：c1 != c2 && c1 != c3 && c2 != c3
+	 * 时间复杂度：O(1)
+	 * 缺点：不保持卡牌顺序（但 SET 游戏不需要保持顺序）
 	 */
-	bool Combinaison::estUnSet() const
+	void Plateau::retirer(CarteId id)
 	{
-		// 测试颜色：全相同 或 全不同
-		// ⚠️ BUG：第二个条件允许 c2 == c3，应该是三者都不同
-		bool test1 = (c1->getCouleur() == c2->getCouleur() && c1->getCouleur() == c3->getCouleur()) ||
-					 (c1->getCouleur() != c2->getCouleur() && c1->getCouleur() != c3->getCouleur() && c2->getCouleur() != c3->getCouleur());
-
-		// 测试形状：全相同 或 全不同
-		bool test2 = (c1->getForme() == c2->getForme() && c1->getForme() == c3->getForme()) ||
-					 (c1->getForme() != c2->getForme() && c1->getForme() != c3->getForme() && c2->getForme() != c3->getForme());
-
-		// 测试数量：全相同 或 全不同
-		bool test3 = (c1->getNombre() == c2->getNombre() && c1->getNombre() == c3->getNombre()) ||
-					 (c1->getNombre() != c2->getNombre() && c1->getNombre() != c3->getNombre() && c2->getNombre() != c3->getNombre());
+		if (!masque.contient(id))
+			throw SetException("this card does not exist");
 
-		// 测试填充：全相同 或 全不同
-		bool test4 = (c1->getRemplissage() == c2->getRemplissage() && c1->getRemplissage() == c3->getRemplissage()) ||
-					 (c1->getRemplissage() != c2->getRemplissage() && c1->getRemplissage() != c3->getRemplissage() && c2->getRemplissage() != c3->getRemplissage());
+		// 用最后一张卡牌替换要移除的卡牌，并更新它的位置
+		std::uint8_t i = position[id];
+		CarteId derniere = cartes[--nb];
+		cartes[i] = derniere;
+		position[derniere] = i;
 
-		// 所有四个特征都必须满足规则
-		return test1 && test2 && test3 && test4;
+		// 减少的 SET：包含 id 且另外两张仍在桌面上的那些
+		masque.retirer(id);
+		nbSets = std::uint8_t(nbSets - compterSetsAvec(id));
 	}
 
 	/**
@@ -445,6 +280,9 @@ namespace Set
 	 *    - 什么都不做
 	 *    - 游戏可能即将结束
 	 *
+	 * 调用者的义务：桌面已有 12 张或更多牌时，只在没有 SET 时调用，
+	 * 否则桌面可能超过 PLATEAU_MAX_CARTES 张，此时在抽牌前抛出 SetException
+	 *
 	 * 实现细节：
 	 * =========
 	 * - 先添加一张牌（确保至少尝试添加一次）
@@ -459,13 +297,246 @@ namespace Set
 	 */
 	void Controleur::distribuer()
 	{
-		// 如果牌堆不为空，先添加一张牌
-		if (!pioche->estVide())
-			plateau.ajouter(pioche->piocher());
+		if (pioche->estVide())
+			return;
+
+		// 如果牌堆不为空，先添加一张牌；如果游戏台少于 12 张牌，继续补充
+		// 需要的张数一次算好，用 piocherN 批量抽取
+		size_t k = 1;
+		if (plateau.getNbCartes() + 1 < config::PLATEAU_MIN_CARTES)
+			k = config::PLATEAU_MIN_CARTES - plateau.getNbCartes();
+		k = std::min(k, pioche->getNbCartes());
+
+		// 调用者在桌面有 SET 时还在加牌（见 config::PLATEAU_MAX_CARTES）：抽牌之前拒绝，状态不变
+		if (plateau.getNbCartes() + k > config::PLATEAU_MAX_CARTES)
+			throw SetException("plateau plein (PLATEAU_MAX_CARTES) : distribuer() seulement quand le plateau n'a pas de SET");
+		memoriser();
+
+		const Carte *tirees[config::PLATEAU_MIN_CARTES];
+		pioche->piocherN(k, tirees);
+		for (size_t i = 0; i < k; i++)
+		{
+			if (observateur)
+				observateur->piocher(tirees[i]->getId());
+			plateau.ajouter(*tirees[i]);
+			if (observateur)
+				observateur->ajouter(tirees[i]->getId());
+		}
+	}
+
+	bool Controleur::jouer(const Combinaison &c)
+	{
+		MasqueCartes m = plateau.getMasque();
+		CarteId a = c.getCarte1().getId(), b = c.getCarte2().getId(), d = c.getCarte3().getId();
+		if (a == b || a == d || b == d || !m.contient(a) || !m.contient(b) || !m.contient(d) || !c.estUnSet())
+			return false;
+		memoriser();
+		if (observateur)
+			observateur->reclamer(Triplet{a, b, d});
+		plateau.retirer(c.getCarte1());
+		plateau.retirer(c.getCarte2());
+		plateau.retirer(c.getCarte3());
+		if (observateur)
+		{
+			observateur->retirer(a);
+			observateur->retirer(b);
+			observateur->retirer(d);
+		}
+		return true;
+	}
+
+	EtatJeu Controleur::sauvegarder() const
+	{
+		EtatJeu e;
+		e.pioche = pioche->getEtat();
+		e.plateau = plateau.getMasque();
+		return e;
+	}
+
+	void Controleur::restaurer(const EtatJeu &e)
+	{
+		pioche->setEtat(e.pioche);
+		// 桌面按编号顺序重建（桌面上卡牌的顺序不影响游戏）
+		plateau.vider();
+		e.plateau.pourChaque([this](CarteId id)
+							 { plateau.ajouter(jeu.getCarte(id)); });
+		if (observateur)
+			observateur->restaurer(e);
+	}
+
+	void Controleur::activerHistorique(size_t capacite)
+	{
+		historique.assign(capacite, EtatJeu());
+		sommet = 0;
+		nbAnnulations = 0;
+	}
+
+	void Controleur::memoriser()
+	{
+		if (historique.empty())
+			return;
+		historique[sommet] = sauvegarder();
+		sommet = (sommet + 1) % historique.size();
+		nbAnnulations = std::min(nbAnnulations + 1, historique.size());
+	}
+
+	bool Controleur::annuler()
+	{
+		if (nbAnnulations == 0)
+			return false;
+		sommet = (sommet + historique.size() - 1) % historique.size();
+		nbAnnulations--;
+		restaurer(historique[sommet]);
+		return true;
+	}
 
-		// 如果游戏台少于 12 张牌，继续补充
-		while (!pioche->estVide() && plateau.getNbCartes() < 12)
-			plateau.ajouter(pioche->piocher());
+	/**
+	 * trouverSets: O(n²) 查找所有 SET
+	 * 每个 SET 会被三对卡各找到一次，只在 c 是三者中编号最大的卡时记录
+	 */
+	std::vector<Triplet> trouverSets(const CarteId *ids, size_t n)
+	{
+		MasqueCartes presentes;
+		for (size_t i = 0; i < n; i++)
+			presentes.ajouter(ids[i]);
+
+		std::vector<Triplet> sets;
+		for (size_t i = 0; i < n; i++)
+			for (size_t j = i + 1; j < n; j++)
+			{
+				CarteId a = ids[i], b = ids[j];
+				CarteId c = troisieme(a, b);
+				if (c > a && c > b && presentes.contient(c))
+				{
+					if (a > b)
+						std::swap(a, b);
+					sets.push_back(Triplet{a, b, c});
+				}
+			}
+		return sets;
+	}
+
+	/**
+	 * compterSets / contientSet 不需要结果本身，用无分支的写法：
+	 * 每个 SET 恰好被它的三对卡各命中一次，所以命中次数除以 3 就是 SET 个数
+	 */
+	size_t compterSets(const CarteId *ids, size_t n)
+	{
+		MasqueCartes presentes;
+		for (size_t i = 0; i < n; i++)
+			presentes.ajouter(ids[i]);
+
+		size_t nb = 0;
+		for (size_t i = 0; i < n; i++)
+			for (size_t j = i + 1; j < n; j++)
+				nb += presentes.contient(troisieme(ids[i], ids[j]));
+		return nb / 3;
+	}
+
+	bool contientSet(const CarteId *ids, size_t n)
+	{
+		MasqueCartes presentes;
+		for (size_t i = 0; i < n; i++)
+			presentes.ajouter(ids[i]);
+
+		for (size_t i = 0; i < n; i++)
+		{
+			bool trouve = false;
+			for (size_t j = i + 1; j < n; j++)
+				trouve |= presentes.contient(troisieme(ids[i], ids[j]));
+			if (trouve)
+				return true;
+		}
+		return false;
+	}
+
+	bool trouverUnSet(const CarteId *ids, size_t n, Triplet &t)
+	{
+		MasqueCartes presentes;
+		for (size_t i = 0; i < n; i++)
+			presentes.ajouter(ids[i]);
+
+		for (size_t i = 0; i < n; i++)
+			for (size_t j = i + 1; j < n; j++)
+			{
+				CarteId c = troisieme(ids[i], ids[j]);
+				if (presentes.contient(c))
+				{
+					CarteId a = ids[i], b = ids[j];
+					// 排序为 a < b < c
+					if (a > b)
+						std::swap(a, b);
+					if (b > c)
+						std::swap(b, c);
+					if (a > b)
+						std::swap(a, b);
+					t = Triplet{a, b, c};
+					return true;
+				}
+			}
+		return false;
+	}
+
+	// ========================================================================
+	// TamponCombinaisons
+	// ========================================================================
+
+	void TamponCombinaisons::ajouterSets(const CarteId *ids, size_t n)
+	{
+		MasqueCartes presentes;
+		for (size_t i = 0; i < n; i++)
+			presentes.ajouter(ids[i]);
+
+		for (size_t i = 0; i < n; i++)
+			for (size_t j = i + 1; j < n; j++)
+			{
+				CarteId a = ids[i], b = ids[j];
+				CarteId c = troisieme(a, b);
+				if (c > a && c > b && presentes.contient(c))
+				{
+					if (a > b)
+						std::swap(a, b);
+					// 编号已经有序且来自桌面，直接打包，不再检查
+					ajouter(CombinaisonCompacte::depuisCode(a | b << 7 | std::uint32_t(c) << 14));
+				}
+			}
+	}
+
+	void TamponCombinaisons::normaliser()
+	{
+		if (normalise)
+			return;
+		std::sort(elements.begin(), elements.end());
+		elements.erase(std::unique(elements.begin(), elements.end()), elements.end());
+		normalise = true;
+	}
+
+	bool TamponCombinaisons::contient(const CombinaisonCompacte &c) const
+	{
+		if (normalise)
+			return std::binary_search(elements.begin(), elements.end(), c);
+		return std::find(elements.begin(), elements.end(), c) != elements.end();
+	}
+
+	void TamponCombinaisons::fusionner(const TamponCombinaisons &autre)
+	{
+		if (&autre == this)
+		{
+			normaliser();
+			return;
+		}
+		if (!autre.normalise)
+		{
+			TamponCombinaisons copie(autre);
+			copie.normaliser();
+			fusionner(copie);
+			return;
+		}
+		normaliser();
+		size_t milieu = elements.size();
+		elements.insert(elements.end(), autre.elements.begin(), autre.elements.end());
+		std::inplace_merge(elements.begin(), elements.begin() + milieu, elements.end());
+		elements.erase(std::unique(elements.begin(), elements.end()), elements.end());
 	}
 
 	/**
@@ -480,8 +551,10 @@ namespace Set
 	 */
 	ostream &operator<<(ostream &f, const Combinaison &c)
 	{
-		f << "[" << c.getCarte1() << " ; " << c.getCarte2() << " ; " << c.getCarte3() << "]";
-		return f;
+		char buf[32];
+		TamponRendu t(buf, sizeof buf);
+		rendre(t, c);
+		return f.write(buf, std::streamsize(t.getTaille()));
 	}
 
 	/**
@@ -503,20 +576,21 @@ namespace Set
 	 */
 	void Plateau::print(ostream &f) const
 	{
-		f << "=================== PLATEAU ===================\n";
-
-		// 遍历并打印所有卡牌
-		for (size_t i = 0; i < nb; i++)
-		{
-			// 每 3 张卡牌换行（创建类似网格的布局）
-			if (i % 3 == 0)
-				f << "\n";
+		// 先渲染到栈上的缓冲区（足够容纳 81 张卡），再一次写入流
+		char buf[TAILLE_MAX_RENDU_PLATEAU];
+		TamponRendu t(buf, sizeof buf);
+		rendre(t);
+		f.write(buf, std::streamsize(t.getTaille()));
+	}
 
-			// 打印卡牌（自动调用 Carte 的 operator<<）
-			f << *cartes[i];
-		}
+	void Plateau::rendre(TamponRendu &t) const
+	{
+		rendrePlateau(t, cartes, nb);
+	}
 
-		f << "\n===============================================\n";
+	void Plateau::rendreJson(TamponRendu &t) const
+	{
+		rendreJsonPlateau(t, cartes, nb);
 	}
 
 	/**
@@ -535,4 +609,79 @@ namespace Set
 		return f;
 	}
 
+	// ========================================================================
+	// 无分配渲染 (Allocation-free Rendering)
+	// ========================================================================
+
+	void rendre(TamponRendu &t, const Combinaison &c)
+	{
+		t.ecrire('[');
+		rendre(t, c.getCarte1());
+		t.ecrire(" ; ");
+		rendre(t, c.getCarte2());
+		t.ecrire(" ; ");
+		rendre(t, c.getCarte3());
+		t.ecrire(']');
+	}
+
+	/**
+	 * 网格格式（与原先逐张输出到流的 Plateau::print 相同）：
+	 * =================== PLATEAU ===================
+	 *
+	 * [RO1P][MO2P][VO3P]
+	 * ...
+	 * ===============================================
+	 */
+	void rendrePlateau(TamponRendu &t, const CarteId *ids, size_t n)
+	{
+		t.ecrire("=================== PLATEAU ===================\n");
+		for (size_t i = 0; i < n; i++)
+		{
+			if (i % 3 == 0)
+				t.ecrire('\n');
+			rendre(t, ids[i]);
+		}
+		t.ecrire("\n===============================================\n");
+	}
+
+	void rendreJson(TamponRendu &t, CarteId id)
+	{
+		if (id >= config::NB_CARTES)
+			throw SetException("carte iexistante");
+		t.ecrire("{\"id\":");
+		t.ecrireEntier(id);
+		t.ecrire(",\"couleur\":\"");
+		t.ecrire(NOMS_COULEUR[chiffre(id, 0)]);
+		t.ecrire("\",\"nombre\":");
+		t.ecrireEntier(chiffre(id, 1) + 1);
+		t.ecrire(",\"forme\":\"");
+		t.ecrire(NOMS_FORME[chiffre(id, 2)]);
+		t.ecrire("\",\"remplissage\":\"");
+		t.ecrire(NOMS_REMPLISSAGE[chiffre(id, 3)]);
+		t.ecrire("\"}");
+	}
+
+	void rendreJson(TamponRendu &t, const Combinaison &c)
+	{
+		t.ecrire('[');
+		rendreJson(t, c.getCarte1());
+		t.ecrire(',');
+		rendreJson(t, c.getCarte2());
+		t.ecrire(',');
+		rendreJson(t, c.getCarte3());
+		t.ecrire(']');
+	}
+
+	void rendreJsonPlateau(TamponRendu &t, const CarteId *ids, size_t n)
+	{
+		t.ecrire('[');
+		for (size_t i = 0; i < n; i++)
+		{
+			if (i)
+				t.ecrire(',');
+			rendreJson(t, ids[i]);
+		}
+		t.ecrire(']');
+	}
+
 }
\ No newline at end of file
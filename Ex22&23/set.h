@@ -7,6 +7,13 @@
 #include <initializer_list>
 #include <array>
 #include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <type_traits>
+#include <utility>
+#include <string_view>
+#include <cassert>
+#include <algorithm>
 
 using namespace std;
 
@@ -57,6 +64,49 @@ namespace Set
 		string info; // 存储错误描述信息
 	};
 
+	/**
+	 * CodeErreur: essayer* 系列接口的返回值，不抛异常、不分配内存
+	 */
+	enum class CodeErreur : std::uint8_t
+	{
+		ok,
+		carteInexistante, // 索引 >= 81
+		finIteration,	  // 迭代器已经遍历完
+		horsLimites,	  // Plateau 迭代器越界
+		piocheVide		  // 牌堆为空
+	};
+
+	/**
+	 * echecVerification: 抛出 SetException
+	 * 单独放在 set.cpp 中并标记为 cold：构造 string 和抛异常的代码不会被内联到调用处的循环里
+	 */
+	[[noreturn]] __attribute__((cold)) void echecVerification(const char *message);
+
+	/**
+	 * verifier: 按 config::VERIFICATION 策略检查条件（见 config.hpp）
+	 * - verifiee:  条件不成立时抛出 SetException(message)
+	 * - assertion: assert(condition)
+	 * - aucune:    什么也不做
+	 */
+	inline void verifier(bool condition, const char *message)
+	{
+		if constexpr (config::VERIFICATION == config::Verification::verifiee)
+		{
+			if (__builtin_expect(!condition, 0))
+				echecVerification(message);
+		}
+		else if constexpr (config::VERIFICATION == config::Verification::assertion)
+		{
+			assert(condition && "SET_VERIFICATION");
+			(void)message;
+		}
+		else
+		{
+			(void)condition;
+			(void)message;
+		}
+	}
+
 	// ========================================================================
 	// 卡牌特征枚举 (Card Characteristics Enumerations)
 	// ========================================================================
@@ -139,6 +189,43 @@ namespace Set
 	string toString(Forme f);
 	string toString(Remplissage v);
 
+	/**
+	 * 字形表：每个特征取值的显示字符（静态 string_view，不分配内存）
+	 * 下标就是该特征的三进制数字（Nombre 为数量减一），与卡牌编号的编码一致
+	 * toString 和 operator<< 都基于这些表
+	 */
+	inline constexpr std::string_view GLYPHES_COULEUR[] = {"R", "M", "V"};
+	inline constexpr std::string_view GLYPHES_NOMBRE[] = {"1", "2", "3"};
+	inline constexpr std::string_view GLYPHES_FORME[] = {"O", "~", "\004"};
+	inline constexpr std::string_view GLYPHES_REMPLISSAGE[] = {"P", "_", "H"};
+
+	/**
+	 * 完整名称（用于 JSON 输出）
+	 */
+	inline constexpr std::string_view NOMS_COULEUR[] = {"rouge", "mauve", "vert"};
+	inline constexpr std::string_view NOMS_FORME[] = {"ovale", "vague", "losange"};
+	inline constexpr std::string_view NOMS_REMPLISSAGE[] = {"plein", "vide", "hachure"};
+
+	/**
+	 * glyphe: 查字形表；取值不合法时抛出 SetException（与 toString 相同）
+	 */
+	constexpr std::string_view glyphe(Couleur c)
+	{
+		return size_t(c) < 3 ? GLYPHES_COULEUR[size_t(c)] : throw SetException("Couleur inconnue");
+	}
+	constexpr std::string_view glyphe(Nombre v)
+	{
+		return size_t(v) - 1 < 3 ? GLYPHES_NOMBRE[size_t(v) - 1] : throw SetException("Nombre inconnue");
+	}
+	constexpr std::string_view glyphe(Forme f)
+	{
+		return size_t(f) < 3 ? GLYPHES_FORME[size_t(f)] : throw SetException("Forme inconnue");
+	}
+	constexpr std::string_view glyphe(Remplissage r)
+	{
+		return size_t(r) < 3 ? GLYPHES_REMPLISSAGE[size_t(r)] : throw SetException("Remplissage inconnu");
+	}
+
 	/**
 	 * operator<< 重载：支持直接输出枚举值到流
 	 * 使用方式：cout << Couleur::rouge << endl;
@@ -178,6 +265,421 @@ namespace Set
 	void printFormes(std::ostream &f = cout);
 	void printRemplissages(std::ostream &f = cout);
 
+	// ========================================================================
+	// 卡牌编号 (Compact Card Id Encoding)
+	// ========================================================================
+
+	/**
+	 * CarteId: 卡牌的紧凑编号（0..80）
+	 *
+	 * 编码方式：每个特征占一位三进制数字
+	 *   id = couleur * 27 + (nombre - 1) * 9 + forme * 3 + remplissage
+	 * 这个顺序与 Jeu 构造函数中 4 层循环的顺序一致，
+	 * 所以 Jeu::getCarte(id) 返回的正是编号为 id 的卡牌
+	 *
+	 * 数学性质：
+	 * - 三张卡构成 SET ⇔ 每一位上的三个数字之和 ≡ 0 (mod 3)
+	 * - 因此任意两张卡 a、b 都唯一确定第三张卡 c：c = -(a + b) (mod 3)，逐位计算
+	 */
+	using CarteId = std::uint8_t;
+
+	/**
+	 * chiffre: 取出编号 id 的第 attribut 位三进制数字
+	 * attribut: 0 = 颜色，1 = 数量，2 = 形状，3 = 填充
+	 */
+	constexpr unsigned chiffre(CarteId id, size_t attribut)
+	{
+		unsigned poids = 1;
+		for (size_t k = attribut + 1; k < config::NB_ATTRIBUTS; k++)
+			poids *= config::NB_VALEURS;
+		return (id / poids) % config::NB_VALEURS;
+	}
+
+	/**
+	 * calculerTroisieme: 逐位计算补全 SET 的第三张卡（编译期可用）
+	 */
+	constexpr CarteId calculerTroisieme(CarteId a, CarteId b)
+	{
+		unsigned id = 0;
+		for (size_t k = 0; k < config::NB_ATTRIBUTS; k++)
+			id = id * config::NB_VALEURS +
+				 (2 * config::NB_VALEURS - chiffre(a, k) - chiffre(b, k)) % config::NB_VALEURS;
+		return static_cast<CarteId>(id);
+	}
+
+	/**
+	 * genererTableTroisieme: 在编译期生成 81x81 的"第三张卡"查找表
+	 */
+	constexpr std::array<std::array<CarteId, config::NB_CARTES>, config::NB_CARTES> genererTableTroisieme()
+	{
+		std::array<std::array<CarteId, config::NB_CARTES>, config::NB_CARTES> t{};
+		for (size_t a = 0; a < config::NB_CARTES; a++)
+			for (size_t b = 0; b < config::NB_CARTES; b++)
+				t[a][b] = calculerTroisieme(static_cast<CarteId>(a), static_cast<CarteId>(b));
+		return t;
+	}
+
+	/**
+	 * TABLE_TROISIEME[a][b]: 与 a、b 构成 SET 的唯一卡牌编号
+	 * - constexpr：表在编译期算好，放在只读数据段，没有运行时初始化
+	 * - 6561 字节，查一次表就能完成 SET 判断
+	 * - TABLE_TROISIEME[a][a] == a（三张相同的卡在规则上也算"全相同"）
+	 */
+	inline constexpr auto TABLE_TROISIEME = genererTableTroisieme();
+
+	constexpr CarteId troisieme(CarteId a, CarteId b) { return TABLE_TROISIEME[a][b]; }
+
+	/**
+	 * estUnSet: 基于编号的 SET 判断，一次查表
+	 */
+	constexpr bool estUnSet(CarteId a, CarteId b, CarteId c) { return TABLE_TROISIEME[a][b] == c; }
+
+	/**
+	 * MasqueCartes: 81 位的卡牌集合（每张卡占一位，位号 = CarteId）
+	 *
+	 * 设计说明：
+	 * - 两个 64 位整数：mots[0] 存 0..63 号卡，mots[1] 存 64..80 号卡
+	 * - 判断"某张卡在不在集合里"只需一次移位和按位与，O(1)
+	 * - 值类型，拷贝就是复制 16 字节
+	 */
+	struct MasqueCartes
+	{
+		std::uint64_t mots[2] = {0, 0};
+
+		constexpr bool contient(CarteId id) const { return (mots[id >> 6] >> (id & 63)) & 1; }
+		constexpr void ajouter(CarteId id) { mots[id >> 6] |= std::uint64_t(1) << (id & 63); }
+		constexpr void retirer(CarteId id) { mots[id >> 6] &= ~(std::uint64_t(1) << (id & 63)); }
+		constexpr bool estVide() const { return (mots[0] | mots[1]) == 0; }
+		size_t getNbCartes() const { return __builtin_popcountll(mots[0]) + __builtin_popcountll(mots[1]); }
+
+		constexpr bool operator==(const MasqueCartes &m) const { return mots[0] == m.mots[0] && mots[1] == m.mots[1]; }
+		constexpr bool operator!=(const MasqueCartes &m) const { return !(*this == m); }
+
+		/**
+		 * pourChaque: 按编号从小到大对集合中的每张卡调用 f(CarteId)
+		 * 每次用 __builtin_ctzll 直接跳到下一个为 1 的位，只访问集合中的卡
+		 */
+		template <typename F>
+		void pourChaque(F f) const
+		{
+			for (size_t m = 0; m < 2; m++)
+				for (std::uint64_t x = mots[m]; x; x &= x - 1)
+					f(CarteId(m * 64 + __builtin_ctzll(x)));
+		}
+
+		/**
+		 * 交集 / 并集：逐字按位运算
+		 */
+		constexpr MasqueCartes operator&(const MasqueCartes &m) const { return MasqueCartes{{mots[0] & m.mots[0], mots[1] & m.mots[1]}}; }
+		constexpr MasqueCartes operator|(const MasqueCartes &m) const { return MasqueCartes{{mots[0] | m.mots[0], mots[1] | m.mots[1]}}; }
+	};
+
+	/**
+	 * MASQUE_JEU_COMPLET: 全部 81 张卡（0..63 位和 64..80 位）
+	 */
+	inline constexpr MasqueCartes MASQUE_JEU_COMPLET{{~std::uint64_t(0), (std::uint64_t(1) << (config::NB_CARTES - 64)) - 1}};
+
+	/**
+	 * genererMasquesAttributs: 在编译期为每个特征的每个取值生成卡牌集合
+	 * MASQUES_ATTRIBUTS[attribut][valeur] = 第 attribut 位三进制数字等于 valeur 的 27 张卡
+	 */
+	constexpr std::array<std::array<MasqueCartes, config::NB_VALEURS>, config::NB_ATTRIBUTS> genererMasquesAttributs()
+	{
+		std::array<std::array<MasqueCartes, config::NB_VALEURS>, config::NB_ATTRIBUTS> t{};
+		for (size_t id = 0; id < config::NB_CARTES; id++)
+			for (size_t k = 0; k < config::NB_ATTRIBUTS; k++)
+				t[k][chiffre(CarteId(id), k)].ajouter(CarteId(id));
+		return t;
+	}
+
+	/**
+	 * MASQUES_ATTRIBUTS: 按特征取值的索引（12 个掩码，共 192 字节，编译期生成）
+	 * 多个条件的组合就是这些掩码的交集，不需要扫描卡牌
+	 */
+	inline constexpr auto MASQUES_ATTRIBUTS = genererMasquesAttributs();
+
+	/**
+	 * FiltreCartes: 一组过滤条件，内部就是满足条件的卡牌集合
+	 *
+	 * 每个条件与对应的预计算掩码求交集，O(1)；条件可以任意组合：
+	 *   FiltreCartes f = FiltreCartes().couleur(Couleur::rouge).remplissage(Remplissage::hachure);
+	 * 任意谓词（不限于特征取值）用 Jeu::filtrer(pred) 构造，只扫描一次 81 张卡
+	 */
+	class FiltreCartes
+	{
+	private:
+		MasqueCartes masque = MASQUE_JEU_COMPLET;
+
+	public:
+		constexpr FiltreCartes() = default;
+		constexpr explicit FiltreCartes(const MasqueCartes &m) : masque(m) {}
+
+		constexpr FiltreCartes &couleur(Couleur c) { return restreindre(0, size_t(c)); }
+		constexpr FiltreCartes &nombre(Nombre n) { return restreindre(1, size_t(n) - 1); }
+		constexpr FiltreCartes &forme(Forme f) { return restreindre(2, size_t(f)); }
+		constexpr FiltreCartes &remplissage(Remplissage r) { return restreindre(3, size_t(r)); }
+
+		/**
+		 * restreindre: 只保留第 attribut 位三进制数字等于 valeur 的卡
+		 */
+		constexpr FiltreCartes &restreindre(size_t attribut, size_t valeur)
+		{
+			masque = masque & MASQUES_ATTRIBUTS[attribut][valeur];
+			return *this;
+		}
+
+		constexpr const MasqueCartes &getMasque() const { return masque; }
+		size_t getNbCartes() const { return masque.getNbCartes(); }
+	};
+
+	/**
+	 * Triplet: 一个 SET 的紧凑表示（三个卡牌编号，按 a < b < c 排序）
+	 * 只有 3 字节，比 Combinaison 的三个指针（24 字节）小得多
+	 */
+	struct Triplet
+	{
+		CarteId a, b, c;
+
+		bool operator==(const Triplet &t) const { return a == t.a && b == t.b && c == t.c; }
+		bool operator!=(const Triplet &t) const { return !(*this == t); }
+	};
+
+	/**
+	 * CombinaisonCompacte: 三张卡的编号打包进一个 32 位整数（4 字节，Combinaison 是 24 字节）
+	 * - code = a | b << 7 | c << 14，a ≤ b ≤ c（构造时排序，同一组卡只有一种表示），高 11 位为 0
+	 * - 比较和哈希都直接作用在 code 上；operator< 即 code 的顺序（先比 c，再比 b，再比 a）
+	 * - 用于大量结果（扫描桌面、回放日志）的存储；需要卡牌属性时再转换为 Combinaison
+	 */
+	class CombinaisonCompacte
+	{
+	private:
+		std::uint32_t code = 0;
+
+		static constexpr unsigned BITS = 7;
+		static constexpr std::uint32_t MASQUE = (1u << BITS) - 1;
+
+		constexpr explicit CombinaisonCompacte(std::uint32_t c) : code(c) {}
+
+		// 无分支排序后打包
+		static constexpr std::uint32_t empaqueter(CarteId x, CarteId y, CarteId z)
+		{
+			unsigned bas = std::min(x, y), haut = std::max(x, y);
+			unsigned a = std::min<unsigned>(bas, z), c = std::max<unsigned>(haut, z);
+			unsigned b = unsigned(x) + y + z - a - c;
+			return a | b << BITS | c << 2 * BITS;
+		}
+
+	public:
+		constexpr CombinaisonCompacte() = default;
+
+		/**
+		 * 从三个编号构造，顺序任意（无分支排序）
+		 * 异常：编号 >= 81 时抛出 SetException（取决于 config::VERIFICATION）
+		 */
+		CombinaisonCompacte(CarteId x, CarteId y, CarteId z)
+		{
+			verifier(x < config::NB_CARTES && y < config::NB_CARTES && z < config::NB_CARTES, "carte iexistante");
+			code = empaqueter(x, y, z);
+		}
+		explicit CombinaisonCompacte(const Triplet &t) : CombinaisonCompacte(t.a, t.b, t.c) {}
+
+		/**
+		 * depuisCode: 从 getCode() 的结果还原，不做检查（用于从文件或缓冲区读回）
+		 */
+		static constexpr CombinaisonCompacte depuisCode(std::uint32_t c) { return CombinaisonCompacte(c); }
+
+		/**
+		 * depuisIds: 与构造函数相同（顺序任意），但不检查编号，调用者保证 < 81（例如来自 Carte::getId()）
+		 */
+		static constexpr CombinaisonCompacte depuisIds(CarteId x, CarteId y, CarteId z) { return CombinaisonCompacte(empaqueter(x, y, z)); }
+
+		constexpr std::uint32_t getCode() const { return code; }
+		constexpr CarteId getA() const { return CarteId(code & MASQUE); }
+		constexpr CarteId getB() const { return CarteId(code >> BITS & MASQUE); }
+		constexpr CarteId getC() const { return CarteId(code >> 2 * BITS); }
+		constexpr Triplet versTriplet() const { return {getA(), getB(), getC()}; }
+
+		bool estUnSet() const { return Set::estUnSet(getA(), getB(), getC()); }
+
+		/**
+		 * hash: 乘法散列（code 只有 21 位有效，直接用作哈希值时低位分布太集中）
+		 */
+		constexpr std::uint64_t hash() const
+		{
+			std::uint64_t h = code * 0x9E3779B97F4A7C15ull;
+			return h ^ (h >> 32);
+		}
+
+		constexpr bool operator==(const CombinaisonCompacte &o) const { return code == o.code; }
+		constexpr bool operator!=(const CombinaisonCompacte &o) const { return code != o.code; }
+		constexpr bool operator<(const CombinaisonCompacte &o) const { return code < o.code; }
+	};
+
+	static_assert(sizeof(CombinaisonCompacte) == 4, "CombinaisonCompacte doit tenir sur 32 bits");
+
+	/**
+	 * HashCombinaisonCompacte: 用于 std::unordered_set / unordered_map
+	 */
+	struct HashCombinaisonCompacte
+	{
+		size_t operator()(const CombinaisonCompacte &c) const { return size_t(c.hash()); }
+	};
+
+	/**
+	 * TamponCombinaisons: 可增长的 CombinaisonCompacte 缓冲区
+	 * - ajouter() 只在末尾追加（O(1) 均摊），不检查重复
+	 * - normaliser() 排序并去重；之后 contient() 用二分查找
+	 * - fusionner() 把另一个缓冲区有序合并进来（两边都先规范化），结果仍有序且无重复
+	 * - 是否已规范化由内部标志记录，已规范化时 normaliser() 不做任何事
+	 *
+	 * 使用示例：
+	 *   TamponCombinaisons t;
+	 *   t.ajouterSets(ids, n);      // 桌面上的全部 SET
+	 *   t.fusionner(autre);         // 合并另一次扫描的结果
+	 *   for (CombinaisonCompacte c : t) { Combinaison comb(c); ... }
+	 */
+	class TamponCombinaisons
+	{
+	private:
+		std::vector<CombinaisonCompacte> elements;
+		bool normalise = true; // 有序且无重复
+
+	public:
+		using const_iterator = std::vector<CombinaisonCompacte>::const_iterator;
+
+		void reserver(size_t n) { elements.reserve(n); }
+		void vider()
+		{
+			elements.clear();
+			normalise = true;
+		}
+
+		void ajouter(const CombinaisonCompacte &c)
+		{
+			if (normalise && !elements.empty() && !(elements.back() < c))
+				normalise = false;
+			elements.push_back(c);
+		}
+		void ajouter(const Triplet &t) { ajouter(CombinaisonCompacte(t)); }
+
+		/**
+		 * ajouterSets: 追加 n 张卡中的全部 SET（算法同 trouverSets，但不构造 Triplet 向量）
+		 */
+		void ajouterSets(const CarteId *ids, size_t n);
+
+		void normaliser();
+		bool estNormalise() const { return normalise; }
+
+		/**
+		 * contient: 已规范化时二分查找，否则顺序查找
+		 */
+		bool contient(const CombinaisonCompacte &c) const;
+
+		/**
+		 * fusionner: 有序合并 autre 的元素并去重；autre 未规范化时先复制一份再规范化
+		 */
+		void fusionner(const TamponCombinaisons &autre);
+
+		size_t getTaille() const { return elements.size(); }
+		bool estVide() const { return elements.empty(); }
+		const CombinaisonCompacte &operator[](size_t i) const { return elements[i]; }
+		const CombinaisonCompacte *donnees() const { return elements.data(); }
+		const_iterator begin() const { return elements.begin(); }
+		const_iterator end() const { return elements.end(); }
+	};
+
+	// ========================================================================
+	// SET 目录与倒排索引 (Set Catalog and Inverted Index)
+	// ========================================================================
+
+	/**
+	 * 整副牌的 SET 个数：任意两张卡唯一确定第三张，每个 SET 被 3 对卡各数一次
+	 * - NB_SETS_JEU = 81 * 80 / 6 = 1080
+	 * - NB_SETS_PAR_CARTE = 80 / 2 = 40（一张卡与其余 80 张两两配对）
+	 */
+	inline constexpr size_t NB_SETS_JEU = config::NB_CARTES * (config::NB_CARTES - 1) / 6;
+	inline constexpr size_t NB_SETS_PAR_CARTE = (config::NB_CARTES - 1) / 2;
+
+	/**
+	 * genererCatalogueSets: 按 (a, b, c) 字典序列出全部 1080 个 SET（编译期执行）
+	 */
+	constexpr std::array<Triplet, NB_SETS_JEU> genererCatalogueSets()
+	{
+		std::array<Triplet, NB_SETS_JEU> t{};
+		size_t n = 0;
+		for (size_t a = 0; a < config::NB_CARTES; a++)
+			for (size_t b = a + 1; b < config::NB_CARTES; b++)
+			{
+				CarteId c = troisieme(CarteId(a), CarteId(b));
+				if (c > b)
+					t[n++] = Triplet{CarteId(a), CarteId(b), c};
+			}
+		return t;
+	}
+
+	/**
+	 * CATALOGUE_SETS: 全部 1080 个 SET（3240 字节，只读数据段）
+	 */
+	inline constexpr auto CATALOGUE_SETS = genererCatalogueSets();
+
+	/**
+	 * genererIndexSets: 倒排索引，每张卡 -> 包含它的 40 个 SET 在 CATALOGUE_SETS 中的下标
+	 */
+	constexpr std::array<std::array<std::uint16_t, NB_SETS_PAR_CARTE>, config::NB_CARTES> genererIndexSets()
+	{
+		std::array<std::array<std::uint16_t, NB_SETS_PAR_CARTE>, config::NB_CARTES> index{};
+		std::array<size_t, config::NB_CARTES> nb{};
+		for (size_t s = 0; s < NB_SETS_JEU; s++)
+		{
+			const Triplet &t = CATALOGUE_SETS[s];
+			index[t.a][nb[t.a]++] = std::uint16_t(s);
+			index[t.b][nb[t.b]++] = std::uint16_t(s);
+			index[t.c][nb[t.c]++] = std::uint16_t(s);
+		}
+		return index;
+	}
+
+	/**
+	 * INDEX_SETS[id]: 包含卡牌 id 的 40 个 SET（81 x 40 x 2 = 6480 字节）
+	 */
+	inline constexpr auto INDEX_SETS = genererIndexSets();
+
+	/**
+	 * compterSetsAvec: 集合 m 中包含卡牌 id 的 SET 个数（id 本身视为在场），O(40)
+	 * 用于增量维护：加入 / 移除一张卡时，SET 总数的变化量正好就是这个值
+	 */
+	inline size_t compterSetsAvec(const MasqueCartes &m, CarteId id)
+	{
+		size_t nb = 0;
+		for (std::uint16_t s : INDEX_SETS[id])
+		{
+			const Triplet &t = CATALOGUE_SETS[s];
+			nb += m.contient(t.a == id ? t.c : t.a) & m.contient(t.b == id ? t.c : t.b);
+		}
+		return nb;
+	}
+
+	/**
+	 * 基于编号的 SET 查找：在 ids[0..n) 这 n 张（互不相同的）卡中找出所有 SET
+	 *
+	 * 算法（O(n²)）：
+	 * 1. 先把 n 张卡放进 MasqueCartes
+	 * 2. 对每一对卡 (x, y) 查表得到第三张 z，再查掩码看 z 是否在场
+	 * 3. 每个 SET 会被它的三对卡各找到一次，只保留 z 编号最大的那一次，避免重复
+	 *
+	 * 对比朴素做法：三重循环 C(n,3) 次判断，每次还要解引用三个指针
+	 * 实现在 set.cpp 中
+	 */
+	std::vector<Triplet> trouverSets(const CarteId *ids, size_t n);
+	size_t compterSets(const CarteId *ids, size_t n);
+	bool contientSet(const CarteId *ids, size_t n);
+
+	/**
+	 * trouverUnSet: 找到第一个 SET 就返回（不分配内存），写入 t
+	 * @return 是否找到
+	 */
+	bool trouverUnSet(const CarteId *ids, size_t n, Triplet &t);
+
 	// ========================================================================
 	// Carte 类：表示单张卡牌 (Card Class)
 	// ========================================================================
@@ -219,6 +721,7 @@ namespace Set
 		Nombre nombre;			 // 卡牌上符号的数量
 		Forme forme;			 // 卡牌符号的形状
 		Remplissage remplissage; // 卡牌符号的填充方式
+		CarteId id;				 // 紧凑编号（0..80），见 carteId()
 
 		// ====================================================================
 		// 私有构造函数 (Private Constructor)
@@ -236,8 +739,8 @@ namespace Set
 		 * - 直接初始化成员，效率高于赋值
 		 * - 对于 const 成员和引用成员，必须使用初始化列表
 		 */
-		Carte(Couleur c, Nombre n, Forme f, Remplissage r)
-			: couleur(c), nombre(n), forme(f), remplissage(r) {}
+		constexpr Carte(Couleur c, Nombre n, Forme f, Remplissage r)
+			: couleur(c), nombre(n), forme(f), remplissage(r), id(carteId(c, n, f, r)) {}
 
 		// ====================================================================
 		// 特殊成员函数 (Special Member Functions)
@@ -261,17 +764,6 @@ namespace Set
 		 */
 		Carte &operator=(const Carte &) = default;
 
-		/**
-		 * 析构函数：使用默认实现
-		 *
-		 * 为什么不需要自定义？
-		 * - Carte 没有管理任何需要手动释放的资源
-		 * - 没有动态分配的内存
-		 * - 没有打开的文件或网络连接
-		 * - 枚举类型的销毁由编译器自动处理
-		 */
-		~Carte() = default;
-
 		// ====================================================================
 		// 友元声明 (Friend Declaration)
 		// ====================================================================
@@ -287,6 +779,22 @@ namespace Set
 		friend class Jeu;
 
 	public:
+		/**
+		 * 析构函数：使用默认实现
+		 *
+		 * 为什么不需要自定义？
+		 * - Carte 没有管理任何需要手动释放的资源
+		 * - 没有动态分配的内存
+		 * - 没有打开的文件或网络连接
+		 * - 枚举类型的销毁由编译器自动处理
+		 *
+		 * 为什么是公有的？
+		 * - 所有卡牌现在存放在 Jeu 的静态对象数组中，
+		 *   程序结束时由 std::array 负责销毁元素，需要能访问析构函数
+		 * - 构造函数仍然私有，外部依然无法创建新的卡牌
+		 */
+		~Carte() = default;
+
 		// ====================================================================
 		// 公有访问器方法 (Public Accessor Methods)
 		// ====================================================================
@@ -299,10 +807,27 @@ namespace Set
 		 * - 返回值类型：直接返回枚举值（值类型，开销小）
 		 * - 命名规范：遵循 getCamelCase 风格
 		 */
-		Couleur getCouleur() const { return couleur; }
-		Nombre getNombre() const { return nombre; }
-		Forme getForme() const { return forme; }
-		Remplissage getRemplissage() const { return remplissage; }
+		constexpr Couleur getCouleur() const { return couleur; }
+		constexpr Nombre getNombre() const { return nombre; }
+		constexpr Forme getForme() const { return forme; }
+		constexpr Remplissage getRemplissage() const { return remplissage; }
+
+		/**
+		 * getId: 获取卡牌的紧凑编号（0..80）
+		 * 满足 Jeu::getInstance().getCarte(c.getId()) 就是 c 本身
+		 */
+		constexpr CarteId getId() const { return id; }
+
+		/**
+		 * carteId: 由四个特征计算编号（编码方式见 CarteId）
+		 */
+		static constexpr CarteId carteId(Couleur c, Nombre n, Forme f, Remplissage r)
+		{
+			return static_cast<CarteId>(static_cast<unsigned>(c) * 27 +
+										(static_cast<unsigned>(n) - 1) * 9 +
+										static_cast<unsigned>(f) * 3 +
+										static_cast<unsigned>(r));
+		}
 	};
 
 	/**
@@ -356,19 +881,38 @@ namespace Set
 		// ====================================================================
 
 		/**
-		 * cartes: 存储所有 81 张卡牌的指针数组
+		 * cartes: 存储所有 81 张卡牌的连续对象数组（静态成员）
 		 *
 		 * 设计细节：
-		 * - const Carte*：指向常量 Carte 的指针，卡牌内容不可修改
+		 * - const Carte：卡牌内容不可修改
 		 * - 固定大小数组：81 = 3^4（4个特征各3种可能）
 		 * - 使用配置常量：config::NB_CARTES，便于统一管理
 		 *
-		 * 为什么是指针数组而不是对象数组？
-		 * 1. Carte 构造函数私有，无法直接创建对象数组
-		 * 2. 指针允许动态分配（new），在运行时创建
-		 * 3. 灵活性：可以在构造函数中逐个创建卡牌
+		 * 原先是指针数组（81 次 new Carte），现在改为对象数组：
+		 * 1. 所有卡牌连续存放（每张 20 字节，一共约 1.6 KB），遍历时顺序读取内存，缓存友好
+		 * 2. Carte 的构造函数是 constexpr，由 genererCartes() 在编译期生成整个数组，
+		 *    属于常量初始化：放在只读数据段，程序启动时不执行任何代码，也没有堆分配
+		 * 3. Carte 构造函数仍然私有，Jeu 是友元，所以只有 Jeu 能生成这个数组
+		 * 4. 下标 i 处的卡牌编号就是 i（与 CarteId 编码一致）
+		 */
+		static const std::array<Carte, config::NB_CARTES> cartes;
+
+		/**
+		 * genererCartes: 按编号依次构造 81 张卡牌（编译期执行）
+		 * 编号的 4 位三进制数字分别还原为颜色、数量、形状、填充
 		 */
-		const Carte *cartes[config::NB_CARTES];
+		static constexpr Carte carteDepuisId(size_t id)
+		{
+			return Carte(static_cast<Couleur>(chiffre(CarteId(id), 0)),
+						 static_cast<Nombre>(chiffre(CarteId(id), 1) + 1),
+						 static_cast<Forme>(chiffre(CarteId(id), 2)),
+						 static_cast<Remplissage>(chiffre(CarteId(id), 3)));
+		}
+		template <size_t... I>
+		static constexpr std::array<Carte, config::NB_CARTES> genererCartes(std::index_sequence<I...>)
+		{
+			return {{carteDepuisId(I)...}};
+		}
 
 		// ====================================================================
 		// 禁用拷贝和赋值 (Deleted Copy and Assignment)
@@ -379,9 +923,7 @@ namespace Set
 		 *
 		 * 为什么删除？
 		 * - 单例模式：不允许创建多个 Jeu 实例
-		 * - 资源管理：避免多个对象管理同一批动态分配的 Carte
-		 * - 防止错误：拷贝会导致两个 Jeu 对象指向相同的 Carte，
-		 *   销毁时会重复释放内存（double free）
+		 * - 语义：卡牌只有一套，复制 Jeu 没有意义
 		 */
 		Jeu(const Jeu &) = delete;
 
@@ -396,28 +938,18 @@ namespace Set
 		// ====================================================================
 
 		/**
-		 * 构造函数：创建所有 81 张卡牌
+		 * 构造函数和析构函数：使用默认实现
 		 *
 		 * 为什么私有？
 		 * - 单例模式要求：外部无法直接创建实例
 		 * - 只能通过 getInstance() 获取唯一实例
 		 *
-		 * 为什么不用 = default？
-		 * - 需要自定义逻辑：生成所有 81 张不同的卡牌
-		 * - 4层嵌套循环遍历所有特征组合
-		 * - 为每张卡牌分配内存（new Carte(...)）
+		 * 为什么可以 = default？
+		 * - 卡牌数组 cartes 是编译期生成的静态成员，不需要在构造函数里逐张 new
+		 * - 也就不需要在析构函数里逐张 delete
 		 */
-		Jeu();
-
-		/**
-		 * 析构函数：释放所有卡牌的内存
-		 *
-		 * 为什么不用 = default？
-		 * - 需要自定义清理：释放 81 张动态分配的 Carte
-		 * - 遵循"谁分配谁释放"原则
-		 * - 防止内存泄漏：必须 delete 每个 new 出来的 Carte
-		 */
-		~Jeu();
+		Jeu() = default;
+		~Jeu() = default;
 
 	public:
 		// ====================================================================
@@ -464,13 +996,33 @@ namespace Set
 		 * - 引用：避免拷贝，提高效率
 		 * - const：保证外部无法修改卡牌
 		 *
-		 * 异常：如果 i >= 81，抛出 SetException
+		 * 异常：如果 i >= 81，抛出 SetException（取决于 config::VERIFICATION）
 		 *
 		 * 前面的 const 确保函数返回对象后这个对象不会变
 		 * 后面的 const 确保成员函数内部不会修改当前类的成员
 		 * 通过 const 加固封装的密闭性
 		 */
-		const Carte &getCarte(size_t i) const;
+		const Carte &getCarte(size_t i) const
+		{
+			verifier(i < config::NB_CARTES, "carte iexistante");
+			return cartes[i];
+		}
+
+		/**
+		 * essayerGetCarte: getCarte 的错误码版本，成功时把卡牌地址写入 sortie
+		 */
+		CodeErreur essayerGetCarte(size_t i, const Carte *&sortie) const noexcept
+		{
+			if (i >= config::NB_CARTES)
+				return CodeErreur::carteInexistante;
+			sortie = &cartes[i];
+			return CodeErreur::ok;
+		}
+
+		/**
+		 * carteParId: 按编号直接取卡，不检查范围（调用者保证 id < 81，例如 id 来自 CombinaisonCompacte）
+		 */
+		static const Carte &carteParId(CarteId id) { return cartes[id]; }
 
 		/**
 		 * getNbCartes: 获取卡牌总数
@@ -484,6 +1036,16 @@ namespace Set
 		 */
 		size_t getNbCartes() const { return config::NB_CARTES; }
 
+		/**
+		 * getTroisieme: 返回与 c1、c2 构成 SET 的唯一卡牌
+		 *
+		 * 实现：查 TABLE_TROISIEME，再按编号取卡（编号即数组下标）
+		 */
+		const Carte &getTroisieme(const Carte &c1, const Carte &c2) const
+		{
+			return cartes[troisieme(c1.getId(), c2.getId())];
+		}
+
 		// ================================================================
 		// 迭代器类：遍历所有卡牌 (Iterator Classes)
 		// ================================================================
@@ -500,14 +1062,15 @@ namespace Set
 		 * 目的：提供一种方法顺序访问聚合对象中的元素，
 		 *      而不暴露其内部表示
 		 *
-		 * 实现方式：使用指向指针的指针
+		 * 实现方式：使用指向数组元素的指针
 		 * - currentCarte: 指向 cartes 数组中当前元素的指针
 		 * - nb: 剩余可迭代的元素数量
 		 *
-		 * 为什么是 const Carte**？
-		 * - cartes 是 const Carte* 类型的数组
-		 * - currentCarte 需要指向数组元素（指针的指针）
+		 * 为什么是 const Carte*？
+		 * - cartes 是连续的 Carte 对象数组
+		 * - currentCarte++ 直接移到下一张卡，顺序读取内存
 		 * - 保持 const 约束，防止修改卡牌
+		 * （卡牌原先存放在指针数组里时，这里是 const Carte**，需要双重解引用）
 		 *
 		 * 使用示例：
 		 *   Jeu::Iterator it = jeu.first();
@@ -521,7 +1084,7 @@ namespace Set
 		class Iterator
 		{
 		private:
-			const Carte **currentCarte; // 指向当前卡牌指针的指针
+			const Carte *currentCarte; // 指向当前卡牌的指针
 			size_t nb;					// 剩余待遍历的卡牌数量
 
 			/**
@@ -531,7 +1094,7 @@ namespace Set
 			 * - c: 指向数组起始位置的指针
 			 * - n: 可迭代的元素数量
 			 */
-			Iterator(const Carte **c, size_t n) : currentCarte(c), nb(n) {}
+			Iterator(const Carte *c, size_t n) : currentCarte(c), nb(n) {}
 
 			friend class Jeu; // 允许 Jeu 访问私有构造函数
 
@@ -561,14 +1124,11 @@ namespace Set
 			 *
 			 * 返回：当前指向的 Carte 对象的引用（返回的是复制的对象还是引用是看函数上面有没有 & ）
 			 *
-			 * 为什么是 **currentCarte？
-			 * - currentCarte 是指向指针的指针（Carte**）
-			 * - *currentCarte 得到 Carte*（指向 Carte 的指针）
-			 * - **currentCarte 得到 Carte 对象本身
+			 * *currentCarte 直接得到 Carte 对象本身
 			 */
 			const Carte &getCurrentItem() const
 			{
-				return **currentCarte; // 双重解引用获取 Carte 对象
+				return *currentCarte; // 解引用获取 Carte 对象
 			}
 		};
 
@@ -583,7 +1143,7 @@ namespace Set
 		 */
 		Iterator first()
 		{
-			const Carte **c = &cartes[0]; // 获取数组首地址
+			const Carte *c = &cartes[0]; // 获取数组首地址
 			return Iterator(c, config::NB_CARTES);
 		}
 
@@ -629,16 +1189,26 @@ namespace Set
 			/**
 			 * next: 移动到下一张卡牌
 			 *
-			 * 安全检查：如果已经遍历完成，抛出异常
+			 * 安全检查：如果已经遍历完成，抛出异常（取决于 config::VERIFICATION）
 			 * 这是一种防御性编程的体现
 			 */
 			void next()
 			{
-				if (isDone())
-					throw SetException("end of iteration");
+				verifier(!isDone(), "end of iteration");
 				i++; // 索引递增
 			}
 
+			/**
+			 * essayerNext: next 的错误码版本
+			 */
+			CodeErreur essayerNext() noexcept
+			{
+				if (isDone())
+					return CodeErreur::finIteration;
+				i++;
+				return CodeErreur::ok;
+			}
+
 			/**
 			 * isDone: 检查是否遍历完成
 			 *
@@ -650,13 +1220,23 @@ namespace Set
 			 * getCurrentItem: 获取当前卡牌
 			 *
 			 * 实现：通过索引调用 getCarte(i)
-			 * 包含安全检查，防止越界访问
+			 * 包含安全检查，防止越界访问（i < getNbCartes() 已保证 getCarte 不会越界）
 			 */
 			const Carte &getCurrentItem() const
+			{
+				verifier(!isDone(), "end of iteration");
+				return instance.cartes[i]; // 通过索引获取卡牌
+			}
+
+			/**
+			 * essayerGetCurrentItem: getCurrentItem 的错误码版本
+			 */
+			CodeErreur essayerGetCurrentItem(const Carte *&sortie) const noexcept
 			{
 				if (isDone())
-					throw SetException("end of iteration");
-				return instance.getCarte(i); // 通过索引获取卡牌
+					return CodeErreur::finIteration;
+				sortie = &instance.cartes[i];
+				return CodeErreur::ok;
 			}
 		};
 
@@ -770,6 +1350,107 @@ namespace Set
 		 */
 		const_iterator end() const { return const_iterator(*this, config::NB_CARTES); }
 
+		/**
+		 * FiltreIterator: 通用过滤迭代器，只访问满足条件的卡牌
+		 *
+		 * 实现原理：
+		 * - 条件先变成 81 位的卡牌集合（FiltreCartes，由预计算的特征掩码求交集得到）
+		 * - next() 用 __builtin_ctzll 直接跳到集合中的下一张卡，不逐张检查
+		 * - 构造时就定位到第一张匹配的卡，没有匹配时 isDone() 立即为 true
+		 *
+		 * 时间复杂度：整个遍历 O(匹配的卡牌数)，与条件的个数和种类无关
+		 *
+		 * 使用示例：
+		 *   // 遍历所有红色、阴影填充的卡牌
+		 *   FiltreCartes f = FiltreCartes().couleur(Couleur::rouge).remplissage(Remplissage::hachure);
+		 *   for (Jeu::FiltreIterator it = jeu.firstFiltreIterator(f); !it.isDone(); it.next())
+		 *       cout << it.getCurrentItem();
+		 */
+		class FiltreIterator
+		{
+		private:
+			MasqueCartes reste; // 还没访问的匹配卡牌
+			size_t i;			// 当前卡牌编号，NB_CARTES 表示遍历结束
+
+			explicit FiltreIterator(const MasqueCartes &m) : reste(m), i(0) { avancer(); }
+
+			/**
+			 * avancer: 取出 reste 中编号最小的卡作为当前卡
+			 */
+			void avancer()
+			{
+				if (reste.mots[0])
+				{
+					i = __builtin_ctzll(reste.mots[0]);
+					reste.mots[0] &= reste.mots[0] - 1;
+				}
+				else if (reste.mots[1])
+				{
+					i = 64 + __builtin_ctzll(reste.mots[1]);
+					reste.mots[1] &= reste.mots[1] - 1;
+				}
+				else
+					i = config::NB_CARTES;
+			}
+
+			friend class Jeu;
+
+		public:
+			void next()
+			{
+				verifier(!isDone(), "end of iteration");
+				avancer();
+			}
+
+			bool isDone() const { return i == config::NB_CARTES; }
+
+			const Carte &getCurrentItem() const
+			{
+				verifier(!isDone(), "end of iteration");
+				return cartes[i];
+			}
+
+			/**
+			 * essayerNext / essayerGetCurrentItem: 错误码版本
+			 */
+			CodeErreur essayerNext() noexcept
+			{
+				if (isDone())
+					return CodeErreur::finIteration;
+				avancer();
+				return CodeErreur::ok;
+			}
+			CodeErreur essayerGetCurrentItem(const Carte *&sortie) const noexcept
+			{
+				if (isDone())
+					return CodeErreur::finIteration;
+				sortie = &cartes[i];
+				return CodeErreur::ok;
+			}
+		};
+
+		/**
+		 * firstFiltreIterator: 创建过滤迭代器，已经指向第一张匹配的卡牌
+		 */
+		FiltreIterator firstFiltreIterator(const FiltreCartes &f) const
+		{
+			return FiltreIterator(f.getMasque());
+		}
+
+		/**
+		 * filtrer: 用任意谓词 pred(const Carte&) 构造过滤条件
+		 * 只在构造时扫描一次 81 张卡，之后的遍历仍然是 O(匹配数)
+		 */
+		template <typename Predicat>
+		static FiltreCartes filtrer(Predicat pred)
+		{
+			MasqueCartes m;
+			for (size_t id = 0; id < config::NB_CARTES; id++)
+				if (pred(cartes[id]))
+					m.ajouter(CarteId(id));
+			return FiltreCartes(m);
+		}
+
 		/**
 		 * FormeIterator: 条件过滤迭代器
 		 *
@@ -783,13 +1464,12 @@ namespace Set
 		 * - 任何基于形状的过滤查询
 		 *
 		 * 实现原理：
-		 * - 在 next() 中跳过不符合条件的卡牌
-		 * - 持续递增索引直到找到匹配的形状或遍历完成
+		 * - 原先在 next() 中逐张跳过不符合条件的卡牌（平均每张匹配的卡要检查 3 张）
+		 * - 现在是 FiltreIterator 的特例：条件只有形状，集合直接取预计算的 MASQUES_ATTRIBUTS
+		 * - 构造时就定位到第一张匹配的卡
 		 *
 		 * 扩展思路：
-		 * - 可以实现 CouleurIterator（按颜色过滤）
-		 * - 可以实现 NombreIterator（按数量过滤）
-		 * - 可以实现通用的 FilterIterator（传入谓词函数）
+		 * - 按颜色、数量或多个特征组合过滤：直接使用 FiltreIterator
 		 *
 		 * 使用示例：
 		 *   // 遍历所有椭圆形卡牌
@@ -802,20 +1482,17 @@ namespace Set
 		class FormeIterator
 		{
 		private:
-			Forme forme;   // 要过滤的形状
-			Jeu &instance; // Jeu 实例引用
-			size_t i;	   // 当前索引
+			Forme forme;	   // 要过滤的形状
+			FiltreIterator it; // 在该形状的 27 张卡中遍历
 
 			/**
 			 * 构造函数：初始化过滤迭代器
 			 *
 			 * 参数：
-			 * - j: Jeu 对象引用
-			 * - index: 起始索引
 			 * - f: 要过滤的形状
 			 */
-			FormeIterator(Jeu &j, size_t index, Forme f)
-				: forme(f), instance(j), i(index) {}
+			explicit FormeIterator(Forme f)
+				: forme(f), it(FiltreCartes().forme(f).getMasque()) {}
 
 			friend class Jeu;
 
@@ -823,56 +1500,192 @@ namespace Set
 			/**
 			 * next: 移动到下一张符合条件的卡牌
 			 *
-			 * 算法：
-			 * 1. 先递增索引（i++）
-			 * 2. 如果未完成且当前卡牌形状不匹配，继续递增
-			 * 3. 直到找到匹配的卡牌或遍历完成
-			 *
-			 * 时间复杂度：
-			 * - 最坏 O(n)，需要遍历所有卡牌
-			 * - 平均 O(1)，因为每种形状约占 1/3
+			 * 时间复杂度：O(1)，不需要检查不匹配的卡牌
 			 */
-			void next()
+			void next() { it.next(); }
+
+			/**
+			 * isDone: 检查是否遍历完成
+			 */
+			bool isDone() const { return it.isDone(); }
+
+			/**
+			 * getCurrentItem: 获取当前卡牌（形状一定是 forme）
+			 */
+			const Carte &getCurrentItem() const { return it.getCurrentItem(); }
+
+			Forme getForme() const { return forme; }
+		};
+
+		/**
+		 * firstFormeIterator: 创建形状过滤迭代器
+		 *
+		 * 参数：
+		 * - f: 要过滤的形状
+		 *
+		 * 返回：指向第一张该形状卡牌的迭代器（不需要先调用 next()）
+		 */
+		FormeIterator firstFormeIterator(Forme f)
+		{
+			return FormeIterator(f);
+		}
+	}; // end of class Jeu
+
+	// ========================================================================
+	// GenerateurAleatoire 类：可播种的随机数生成器 (Seeded PRNG)
+	// ========================================================================
+
+	/**
+	 * GenerateurAleatoire: PCG32 随机数生成器（每个对象一个独立的状态）
+	 *
+	 * 为什么不用 rand()？
+	 * - rand() 是全局状态：多个线程同时调用会互相干扰，结果无法复现
+	 * - rand() % n 有取模偏差：n 不整除 RAND_MAX + 1 时小数字概率更大
+	 *
+	 * PCG32 的特点：
+	 * - 状态只有 16 字节，每次生成只需一次乘法和几次移位
+	 * - graine 决定起点，flux 决定使用哪一条随机流（不同 flux 的序列互相独立）
+	 *   多线程时每个线程用同一个 graine、不同的 flux 即可
+	 * - 满足 UniformRandomBitGenerator 要求，可直接用于 std::shuffle 等算法
+	 */
+	class GenerateurAleatoire
+	{
+	private:
+		std::uint64_t etat;		  // 当前状态
+		std::uint64_t increment;  // 由 flux 决定，必须是奇数
+
+	public:
+		using result_type = std::uint32_t;
+
+		explicit GenerateurAleatoire(std::uint64_t graine = 0x853c49e6748fea9bULL, std::uint64_t flux = 0)
+			: etat(0), increment((flux << 1) | 1)
+		{
+			(*this)();
+			etat += graine;
+			(*this)();
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return 0xffffffffu; }
+
+		/**
+		 * operator(): 生成下一个 32 位随机数（PCG-XSH-RR）
+		 */
+		result_type operator()()
+		{
+			std::uint64_t ancien = etat;
+			etat = ancien * 6364136223846793005ULL + increment;
+			std::uint32_t x = std::uint32_t(((ancien >> 18) ^ ancien) >> 27);
+			std::uint32_t r = std::uint32_t(ancien >> 59);
+			return (x >> r) | (x << ((32 - r) & 31));
+		}
+
+		/**
+		 * borne: 生成 [0, n) 之间均匀分布的整数（无取模偏差，Lemire 方法）
+		 * 大多数情况下只需一次乘法，拒绝重试的概率小于 n / 2^32
+		 */
+		std::uint32_t borne(std::uint32_t n)
+		{
+			std::uint64_t m = std::uint64_t((*this)()) * n;
+			std::uint32_t bas = std::uint32_t(m);
+			if (bas < n)
 			{
-				i++; // 移动到下一张卡
-				// 跳过不符合条件的卡牌
-				while (!isDone() &&
-					   instance.getCarte(i).getForme() != forme)
-					i++;
+				std::uint32_t seuil = (0u - n) % n;
+				while (bas < seuil)
+				{
+					m = std::uint64_t((*this)()) * n;
+					bas = std::uint32_t(m);
+				}
 			}
+			return std::uint32_t(m >> 32);
+		}
+	};
 
-			/**
-			 * isDone: 检查是否遍历完成
-			 */
-			bool isDone() const { return i == instance.getNbCartes(); }
+	// ========================================================================
+	// EtatJeu：紧凑的游戏状态快照 (Compact Game-state Snapshot)
+	// ========================================================================
 
-			/**
-			 * getCurrentItem: 获取当前卡牌
-			 *
-			 * 前提：当前索引指向的卡牌形状匹配 forme
-			 */
-			const Carte &getCurrentItem() const
-			{
-				return instance.getCarte(i);
-			}
-		};
+	/**
+	 * EtatPioche: 牌堆的完整状态
+	 * - ordre[0..nb)：剩余卡牌的编号，顺序与 Pioche 内部数组一致
+	 * - generateur：随机数生成器的当前状态（恢复后接下来抽到的牌完全相同）
+	 */
+	struct EtatPioche
+	{
+		CarteId ordre[config::NB_CARTES];
+		std::uint8_t nb;
+		GenerateurAleatoire generateur;
+	};
+
+	/**
+	 * ZOBRIST: Zobrist 哈希的随机键，编译期由 splitmix64 生成
+	 * - ZOBRIST[id]：卡牌 id 在桌面上
+	 * - ZOBRIST[NB_CARTES + id]：卡牌 id 在牌堆中
+	 * 状态的哈希 = 所有"卡牌-位置"键的异或；一张卡移动时只会改变两个键，所以调用者可以自己维护增量哈希
+	 * （h ^= ZOBRIST[旧位置] ^ ZOBRIST[新位置]）；下面的 hashZobrist 则按集合重新计算，O(卡牌数)
+	 */
+	constexpr std::array<std::uint64_t, 2 * config::NB_CARTES> genererZobrist()
+	{
+		std::array<std::uint64_t, 2 * config::NB_CARTES> cles{};
+		std::uint64_t x = 0x5e7ca4d5e7ca4d5eULL;
+		for (size_t i = 0; i < cles.size(); i++)
+		{
+			x += 0x9e3779b97f4a7c15ULL;
+			std::uint64_t z = x;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			cles[i] = z ^ (z >> 31);
+		}
+		return cles;
+	}
+	inline constexpr auto ZOBRIST = genererZobrist();
+
+	/**
+	 * hashZobrist: 由桌面和牌堆的卡牌集合计算哈希（与卡牌顺序无关）
+	 * 用作置换表（transposition table）的键：不同的出牌顺序到达同一局面时哈希相同
+	 */
+	inline std::uint64_t hashZobrist(const MasqueCartes &plateau, const MasqueCartes &pioche)
+	{
+		std::uint64_t h = 0;
+		plateau.pourChaque([&h](CarteId id)
+						   { h ^= ZOBRIST[id]; });
+		pioche.pourChaque([&h](CarteId id)
+						  { h ^= ZOBRIST[config::NB_CARTES + id]; });
+		return h;
+	}
+
+	/**
+	 * EtatJeu: 一局游戏的完整状态（值类型，可平凡拷贝，120 字节）
+	 *
+	 * 为什么需要？
+	 * - Pioche 和 Controleur 禁止拷贝，Plateau 只包含桌面，不包含牌堆
+	 * - 搜索、悔棋、"如果当时选了另一个 SET"之类的分析需要大量保存/恢复状态
+	 *
+	 * 内容：
+	 * - pioche：牌堆顺序和随机数状态（见 EtatPioche）
+	 * - plateau：桌面卡牌集合（81 位掩码；桌面上卡牌的顺序不影响游戏）
+	 * 保存和恢复都是固定大小的拷贝，与对局进行到哪一步无关
+	 */
+	struct EtatJeu
+	{
+		EtatPioche pioche;
+		MasqueCartes plateau;
 
 		/**
-		 * firstFormeIterator: 创建形状过滤迭代器
-		 *
-		 * 参数：
-		 * - f: 要过滤的形状
-		 *
-		 * 返回：指向第一张该形状卡牌的迭代器
-		 *
-		 * 注意：如果第一张卡不是目标形状，
-		 *      用户需要先调用 next() 才能找到第一张匹配的卡
+		 * getMasquePioche: 牌堆中剩余卡牌的集合
 		 */
-		FormeIterator firstFormeIterator(Forme f)
+		MasqueCartes getMasquePioche() const
 		{
-			return FormeIterator(*this, 0, f);
+			MasqueCartes m;
+			for (size_t i = 0; i < pioche.nb; i++)
+				m.ajouter(pioche.ordre[i]);
+			return m;
 		}
-	}; // end of class Jeu
+
+		std::uint64_t getHash() const { return hashZobrist(plateau, getMasquePioche()); }
+	};
+
+	static_assert(std::is_trivially_copyable<EtatJeu>::value, "EtatJeu doit etre un type valeur");
 
 	// ========================================================================
 	// Pioche 类：牌堆管理类 (Draw Pile Class)
@@ -908,7 +1721,12 @@ namespace Set
 	 * 功能说明：
 	 * - 初始化时包含所有 81 张卡牌
 	 * - piocher() 随机抽取一张卡并将其从牌堆移除
+	 * - piocherN() 一次抽取多张卡
 	 * - 支持查询剩余卡牌数量和是否为空
+	 *
+	 * 随机性：
+	 * - 每个 Pioche 有自己的 GenerateurAleatoire，给定 graine/flux 后抽牌顺序完全可复现
+	 * - 两种抽牌模式（见 ModeTirage），得到的抽牌顺序分布相同（都是均匀随机排列）
 	 */
 	class Pioche
 	{
@@ -941,6 +1759,24 @@ namespace Set
 		 */
 		size_t nb;
 
+	public:
+		/**
+		 * ModeTirage: 抽牌模式
+		 * - aleatoire: 每次抽牌时随机选一个位置（原来的做法）
+		 * - melangee: 构造时先整体洗一次牌（Fisher-Yates），之后每次抽牌只是取末尾一张，
+		 *             不再调用随机数生成器
+		 */
+		enum class ModeTirage
+		{
+			aleatoire,
+			melangee
+		};
+
+	private:
+		GenerateurAleatoire generateur; // 本牌堆专用的随机数生成器
+		ModeTirage mode;				// 抽牌模式
+		MasqueCartes masque = MASQUE_JEU_COMPLET; // 剩余卡牌的集合，与 cartes[0..nb) 同步维护
+
 	public:
 		// ====================================================================
 		// 构造函数 (Constructor)
@@ -962,7 +1798,17 @@ namespace Set
 		 * 时间复杂度：O(n)，n = 81
 		 * 空间复杂度：O(n)，分配 81 个指针
 		 */
-		explicit Pioche(Jeu &j) : nb(config::NB_CARTES)
+		explicit Pioche(Jeu &j) : Pioche(j, GenerateurAleatoire()) {}
+
+		/**
+		 * 构造函数：使用指定的随机数生成器和抽牌模式
+		 *
+		 * 参数：
+		 * - g: 随机数生成器，例如 GenerateurAleatoire(graine, flux)
+		 * - m: 抽牌模式，melangee 时在这里洗牌
+		 */
+		Pioche(Jeu &j, const GenerateurAleatoire &g, ModeTirage m = ModeTirage::aleatoire)
+			: nb(config::NB_CARTES), generateur(g), mode(m)
 		{
 			// 动态分配指针数组
 			cartes = new const Carte *[config::NB_CARTES];
@@ -971,6 +1817,9 @@ namespace Set
 			// 注意：这里只复制地址（浅拷贝），不复制 Carte 对象
 			for (size_t i = 0; i < j.getNbCartes(); i++)
 				cartes[i] = &j.getCarte(i);
+
+			if (mode == ModeTirage::melangee)
+				melanger();
 		}
 
 		// ====================================================================
@@ -1005,11 +1854,12 @@ namespace Set
 		 *
 		 * 算法：
 		 * 1. 检查牌堆是否为空，空则抛出异常
-		 * 2. 生成随机索引 i（0 到 nb-1）
+		 * 2. 用 generateur 生成随机索引 i（0 到 nb-1，无偏差）
 		 * 3. 保存 cartes[i]（要返回的卡牌）
-		 * 4. 将 cartes[nb-1]（最后一张）移到位置 i
+		 * 4. 交换 cartes[i] 和 cartes[nb-1]（最后一张）
 		 * 5. nb--（减少牌堆大小）
 		 * 6. 返回被抽中的卡牌
+		 * melangee 模式下牌已洗好，直接返回 cartes[--nb]
 		 *
 		 * 时间复杂度：O(1)
 		 *
@@ -1023,6 +1873,40 @@ namespace Set
 		 */
 		const Carte &piocher();
 
+		/**
+		 * essayerPiocher: piocher 的错误码版本，牌堆为空时返回 CodeErreur::piocheVide
+		 */
+		CodeErreur essayerPiocher(const Carte *&sortie) noexcept
+		{
+			if (estVide())
+				return CodeErreur::piocheVide;
+			sortie = &piocher();
+			return CodeErreur::ok;
+		}
+
+		/**
+		 * piocherN: 一次抽取 k 张卡牌，依次写入 sortie[0..k)
+		 *
+		 * 与连续调用 k 次 piocher() 的结果相同，但只检查一次边界
+		 * 异常：剩余卡牌少于 k 张时抛出 SetException
+		 */
+		void piocherN(size_t k, const Carte **sortie);
+
+		/**
+		 * melanger: 对剩余的卡牌做一次 Fisher-Yates 洗牌
+		 * 洗牌后 piocher() 直接取末尾的卡（melangee 模式在构造时自动调用）
+		 */
+		void melanger();
+
+		ModeTirage getMode() const { return mode; }
+
+		/**
+		 * getEtat / setEtat: 导出、恢复牌堆的完整状态（用于 EtatJeu 快照）
+		 * 恢复后的抽牌结果与保存时完全相同
+		 */
+		EtatPioche getEtat() const;
+		void setEtat(const EtatPioche &e);
+
 		/**
 		 * getNbCartes: 获取剩余卡牌数量
 		 */
@@ -1033,6 +1917,11 @@ namespace Set
 		 */
 		bool estVide() const { return nb == 0; }
 
+		/**
+		 * getMasque: 剩余卡牌的集合（O(1)，用于哈希，不需要构造 EtatPioche）
+		 */
+		const MasqueCartes &getMasque() const { return masque; }
+
 		// ====================================================================
 		// 禁用拷贝和赋值 (Deleted Copy and Assignment)
 		// ====================================================================
@@ -1054,6 +1943,8 @@ namespace Set
 		Pioche &operator=(const Pioche &p) = delete;
 	};
 
+	class TamponRendu; // 渲染缓冲区，定义见下文"无分配渲染"一节
+
 	// ========================================================================
 	// Plateau 类：游戏桌面类 (Game Board Class)
 	// ========================================================================
@@ -1065,33 +1956,35 @@ namespace Set
 	 *
 	 * 问题8：Carte 与 Plateau 的关系
 	 * - 聚合关系（Aggregation，空心菱形）
-	 * - Plateau 持有指向 Carte 的指针，但不拥有 Carte
+	 * - Plateau 记录卡牌编号，按编号从 Jeu 取 Carte，但不拥有 Carte
 	 * - Carte 的生命周期由 Jeu 管理
 	 * - Plateau 销毁时不删除 Carte 对象
 	 * - UML表示：Plateau ◇——> Carte (1对多的聚合)
 	 *
-	 * 问题9：为什么需要自定义拷贝构造和赋值运算符？
+	 * 问题9：为什么不需要自定义拷贝构造和赋值运算符？
 	 *
-	 * 如果使用默认版本会发生什么？
-	 * - 浅拷贝：两个 Plateau 对象的 cartes 指针指向同一个数组
-	 * - 修改一个会影响另一个
+	 * 如果 Plateau 在堆上存数组（const Carte** 加 new[]），默认版本是浅拷贝：
+	 * - 两个 Plateau 对象的指针指向同一个数组，修改一个会影响另一个
 	 * - 析构时会双重释放同一块内存（double free）→ 崩溃
+	 * - 所以必须手写深拷贝，而每次拷贝都要分配内存
+	 *
+	 * 现在的做法：所有数据都存放在对象内部，没有指针成员
+	 * - 默认的拷贝构造和赋值逐字节复制，本身就是正确的"深拷贝"
+	 * - Plateau 可平凡拷贝（trivially copyable）：拷贝就是一次 memcpy，不分配内存
+	 * - 模拟和搜索中大量拷贝桌面时不再有堆分配
+	 *
+	 * 固定容量设计（稀疏集合 sparse set）：
+	 * - cartes[0..nb)：桌面上的卡牌编号（顺序无关），容量 PLATEAU_MAX_CARTES（21）
+	 * - position[id]：编号为 id 的卡在 cartes 中的位置，只对 masque 中的卡有效，
+	 *   所以移除时不需要清理
+	 * - contient / ajouter / retirer 都是 O(1)
 	 *
-	 * 正确做法：
-	 * - 深拷贝：分配新的数组，复制所有指针
-	 * - 每个 Plateau 拥有独立的数组
-	 * - 但数组中的指针仍指向 Jeu 中的 Carte（聚合关系）
-	 *
-	 * 动态数组设计：
-	 * - cartes: 动态分配的指针数组
-	 * - nbMax: 数组的容量（已分配的大小）
-	 * - nb: 当前实际使用的元素数量
-	 * - 当 nb == nbMax 时需要扩容
-	 *
-	 * 扩容策略：
-	 * - 每次增加固定大小（如 5）
-	 * - 类似于 std::vector 的动态增长
-	 * - 也可以采用倍增策略（如 *2）以均摊 O(1)
+	 * 为什么 21 张就够？
+	 * - 最大的无 SET 卡牌集合有 20 张，只要调用者遵守"有 SET 时不加牌"的规则，
+	 *   桌面不会超过 21 张（见 config::PLATEAU_MAX_CARTES）
+	 * - 超出容量时 ajouter 抛出 SetException，而不是扩容
+	 *
+	 * 大小：16（masque）+ 1 + 1 + 21 + 81 = 120 字节，全部在对象内部
 	 */
 	class Plateau
 	{
@@ -1101,65 +1994,49 @@ namespace Set
 		// ====================================================================
 
 		/**
-		 * cartes: 指向卡牌指针的动态数组
+		 * masque: 桌面卡牌的 81 位集合，与 cartes 同步维护
+		 * nbSets: 桌面上的 SET 个数（21 张卡最多 70 个 SET）
 		 *
-		 * 类型：const Carte**
-		 * - 动态分配，支持扩容
-		 * - 存储指向 Carte 的指针（聚合）
+		 * 增量维护（每次 ajouter / retirer 查 TABLE_TROISIEME，O(nb)）：
+		 * - 加入卡 x：新增的 SET 正好是包含 x、另外两张都已在场的那些
+		 * - 移除卡 x：减少的 SET 同理
+		 * 所以 countSets() / hasSet() 是 O(1)，发牌后不需要重新扫描整个桌面
 		 */
-		const Carte **cartes;
+		MasqueCartes masque;
+		std::uint8_t nbSets = 0;
 
 		/**
-		 * nbMax: 数组的最大容量
-		 *
-		 * 表示当前已分配的数组大小
-		 * 当 nb 达到 nbMax 时需要扩容
+		 * nb: 当前桌面上的卡牌数量
+		 * 范围：0 <= nb <= PLATEAU_MAX_CARTES
 		 */
-		size_t nbMax;
+		std::uint8_t nb = 0;
 
 		/**
-		 * nb: 当前桌面上的卡牌数量
-		 *
-		 * 表示数组中实际使用的元素数量
-		 * 范围：0 <= nb <= nbMax
+		 * cartes: 卡牌编号数组（前 nb 个有效），存放在对象内部
 		 */
-		size_t nb;
+		CarteId cartes[config::PLATEAU_MAX_CARTES] = {};
 
-	public:
-		// ====================================================================
-		// 构造函数 (Constructor)
-		// ====================================================================
+		/**
+		 * position: 编号 -> 在 cartes 中的位置
+		 */
+		std::uint8_t position[config::NB_CARTES] = {};
 
 		/**
-		 * 默认构造函数：创建空的桌面
-		 *
-		 * 初始化策略：
-		 * - 分配初始容量（5 个位置）
-		 * - 初始时没有卡牌（nb = 0）
-		 *
-		 * 为什么初始容量是 5？
-		 * - 避免频繁扩容
-		 * - 不要太大（浪费内存）
-		 * - 可以通过配置文件调整
+		 * compterSetsAvec: 桌面上包含卡牌 id 的 SET 个数（id 不在桌面上时），O(nb)
 		 */
-		Plateau()
-		{
-			cartes = new const Carte *[5]; // 分配初始数组
-			nbMax = 5;					   // 设置容量
-			nb = 0;						   // 初始为空
-		}
+		size_t compterSetsAvec(CarteId id) const;
 
+	public:
 		// ====================================================================
-		// 析构函数 (Destructor)
+		// 构造、拷贝与析构 (Constructor, Copy and Destructor)
 		// ====================================================================
 
 		/**
-		 * 析构函数：释放动态分配的数组
+		 * 默认构造函数：创建空的桌面，不分配内存
 		 *
-		 * 注意：只删除指针数组，不删除 Carte 对象
-		 * 原因：聚合关系，Carte 由 Jeu 管理
+		 * 拷贝构造、赋值和析构都使用编译器生成的版本（见上面问题9）
 		 */
-		~Plateau() { delete[] cartes; }
+		Plateau() = default;
 
 		// ====================================================================
 		// 公有方法 (Public Methods)
@@ -1169,81 +2046,65 @@ namespace Set
 		 * getNbCartes: 获取桌面上的卡牌数量
 		 */
 		size_t getNbCartes() const { return nb; }
+		bool estVide() const { return nb == 0; }
 
 		/**
-		 * ajouter: 向桌面添加一张卡牌
-		 *
-		 * 参数：c - 要添加的卡牌引用
-		 *
-		 * 算法：
-		 * 1. 检查是否需要扩容（nb == nbMax）
-		 * 2. 如果需要，分配更大的数组并复制
-		 * 3. 将卡牌指针添加到数组末尾
-		 * 4. nb++
-		 *
-		 * 扩容策略：
-		 * - 创建大小为 (nbMax + 5) 的新数组
-		 * - 复制所有现有指针
-		 * - 删除旧数组
-		 * - 更新 cartes 和 nbMax
-		 *
-		 * 时间复杂度：
-		 * - 不扩容：O(1)
-		 * - 扩容：O(n)
-		 *
-		 * 实现在 set.cpp 中
+		 * getIds: 卡牌编号数组（共 getNbCartes() 个），可直接传给 trouverSets 等函数
 		 */
-		void ajouter(const Carte &c);
+		const CarteId *getIds() const { return cartes; }
 
 		/**
-		 * retirer: 从桌面移除一张卡牌
-		 *
-		 * 参数：c - 要移除的卡牌引用
-		 *
-		 * 算法：
-		 * 1. 遍历数组查找卡牌地址
-		 * 2. 如果找到，用最后一张卡填补空位
-		 * 3. nb--
-		 * 4. 如果未找到，抛出异常
-		 *
-		 * 时间复杂度：O(n)
-		 *
-		 * 实现在 set.cpp 中
+		 * getMasque: 桌面卡牌的 81 位集合（用于 EtatJeu 快照和哈希）
+		 */
+		const MasqueCartes &getMasque() const { return masque; }
+
+		/**
+		 * contient: 卡牌是否在桌面上，O(1)
+		 */
+		bool contient(CarteId id) const { return masque.contient(id); }
+		bool contient(const Carte &c) const { return contient(c.getId()); }
+
+		/**
+		 * vider: 清空桌面
 		 */
-		void retirer(const Carte &c);
+		void vider()
+		{
+			nb = 0;
+			masque = MasqueCartes();
+			nbSets = 0;
+		}
 
 		/**
-		 * 拷贝构造函数：深拷贝 Plateau
+		 * ajouter: 向桌面添加一张卡牌，O(1)
 		 *
-		 * 为什么需要？
-		 * - 避免浅拷贝导致的双重释放
-		 * - 每个 Plateau 需要独立的数组
+		 * 算法：
+		 * 1. 把编号放到 cartes 末尾，并在 position 中记录位置
+		 * 2. nb++，并更新 masque 和 nbSets
 		 *
-		 * 实现：
-		 * 1. 分配新的数组（大小为 p.nbMax）
-		 * 2. 复制所有卡牌指针
-		 * 3. 复制 nb 和 nbMax
+		 * 异常（SetException）：
+		 * - 卡牌已在桌面上（同一张卡不能出现两次）
+		 * - 桌面已有 PLATEAU_MAX_CARTES 张：调用者违反了"有 SET 时不加牌"的规则
+		 *   （见 config::PLATEAU_MAX_CARTES）
 		 *
 		 * 实现在 set.cpp 中
 		 */
-		Plateau(const Plateau &p);
+		void ajouter(CarteId id);
+		void ajouter(const Carte &c) { ajouter(c.getId()); }
 
 		/**
-		 * 赋值运算符：深拷贝赋值
+		 * retirer: 从桌面移除一张卡牌，O(1)
 		 *
-		 * 必须处理：
-		 * 1. 自赋值检查（if (this != &p)）
-		 * 2. 释放当前资源或重用现有数组
-		 * 3. 复制新数据
+		 * 算法：
+		 * 1. 通过 position 直接找到卡牌的位置
+		 * 2. 用最后一张卡填补空位，并更新它的 position
+		 * 3. nb--，并更新 masque 和 nbSets
 		 *
-		 * 实现策略：
-		 * - 清空当前内容（nb = 0）
-		 * - 逐个添加源对象的卡牌（调用 ajouter）
-		 * - 利用 ajouter 的扩容机制
+		 * 异常：卡牌不在桌面上时抛出 SetException
 		 *
 		 * 实现在 set.cpp 中
 		 */
-		Plateau &operator=(const Plateau &p);
+		void retirer(CarteId id);
+		void retirer(const Carte &c) { retirer(c.getId()); }
 
 		/**
 		 * print: 打印桌面上的所有卡牌
@@ -1256,6 +2117,33 @@ namespace Set
 		 */
 		void print(ostream &f) const;
 
+		/**
+		 * rendre / rendreJson: 把整个桌面渲染到调用者的缓冲区（见 TamponRendu）
+		 * print 就是 rendre 之后一次写入流
+		 */
+		void rendre(TamponRendu &t) const;
+		void rendreJson(TamponRendu &t) const;
+
+		// ====================================================================
+		// SET 查找 (Board-wide Set Enumeration)
+		// ====================================================================
+
+		/**
+		 * findSets: 找出桌面上所有的 SET
+		 * countSets: 只统计 SET 的个数（不构造结果）
+		 * hasSet: 判断桌面上是否至少有一个 SET
+		 *
+		 * 实现：
+		 * - findSets 直接在编号数组上调用 trouverSets，
+		 *   利用 81 位掩码和 TABLE_TROISIEME，复杂度 O(n²) 而不是 O(n³)
+		 * - countSets / hasSet 直接返回增量维护的 nbSets，O(1)
+		 *
+		 * 返回的 Triplet 可通过 Combinaison(const Triplet&) 还原为卡牌组合
+		 */
+		std::vector<Triplet> findSets() const { return trouverSets(cartes, nb); }
+		size_t countSets() const { return nbSets; }
+		bool hasSet() const { return nbSets != 0; }
+
 		// ====================================================================
 		// STL 风格迭代器 (STL-style Iterator)
 		// ====================================================================
@@ -1327,10 +2215,20 @@ namespace Set
 			 * 返回：当前位置的 Carte 引用
 			 */
 			const Carte &operator*() const
+			{
+				verifier(index < plateau.nb, "Iterator out of bounds");
+				return Jeu::carteParId(plateau.cartes[index]);
+			}
+
+			/**
+			 * essayerLire: operator* 的错误码版本
+			 */
+			CodeErreur essayerLire(const Carte *&sortie) const noexcept
 			{
 				if (index >= plateau.nb)
-					throw SetException("Iterator out of bounds");
-				return *plateau.cartes[index];
+					return CodeErreur::horsLimites;
+				sortie = &Jeu::carteParId(plateau.cartes[index]);
+				return CodeErreur::ok;
 			}
 		};
 
@@ -1361,6 +2259,9 @@ namespace Set
 	 */
 	ostream &operator<<(ostream &f, const Plateau &c);
 
+	static_assert(std::is_trivially_copyable<Plateau>::value,
+				  "Plateau doit pouvoir etre copie par memcpy");
+
 	// ========================================================================
 	// Combinaison 类：三卡组合类 (Three-Card Combination Class)
 	// ========================================================================
@@ -1445,8 +2346,27 @@ namespace Set
 		 */
 		Combinaison(const Carte &C1, const Carte &C2, const Carte &C3)
 			: c1(&C1), c2(&C2), c3(&C3) {}
+
+		/**
+		 * 构造函数：从紧凑的 Triplet 还原组合
+		 * 编号即 Jeu 中的下标，所以直接按编号取卡
+		 */
+		explicit Combinaison(const Triplet &t)
+			: c1(&Jeu::getInstance().getCarte(t.a)),
+			  c2(&Jeu::getInstance().getCarte(t.b)),
+			  c3(&Jeu::getInstance().getCarte(t.c)) {}
 		// 注意存储的是指针，所以后面需要通过 -> 调取属性、方法
 
+		/**
+		 * 与 CombinaisonCompacte 互相转换：只是三次查表 / 三次读取编号，没有检查也没有分配
+		 * 注意转换为紧凑形式时会排序，所以卡牌顺序不一定保留
+		 */
+		explicit Combinaison(const CombinaisonCompacte &c)
+			: c1(&Jeu::carteParId(c.getA())),
+			  c2(&Jeu::carteParId(c.getB())),
+			  c3(&Jeu::carteParId(c.getC())) {}
+		CombinaisonCompacte versCompacte() const { return CombinaisonCompacte::depuisIds(c1->getId(), c2->getId(), c3->getId()); }
+
 		// ====================================================================
 		// 访问器方法 (Accessor Methods)
 		// ====================================================================
@@ -1477,11 +2397,12 @@ namespace Set
 		 * 2. 每个特征返回 true/false
 		 * 3. 四个结果进行 AND 运算
 		 *
-		 * 时间复杂度：O(1)（固定的4个特征检查）
+		 * 时间复杂度：O(1)
 		 *
-		 * 实现在 set.cpp 中
+		 * 优化：不再逐个比较 4 个特征，而是用卡牌编号查 TABLE_TROISIEME，
+		 *      c1、c2 唯一确定的第三张卡等于 c3 即为 SET
 		 */
-		bool estUnSet() const;
+		bool estUnSet() const { return Set::estUnSet(c1->getId(), c2->getId(), c3->getId()); }
 
 		// ====================================================================
 		// 特殊成员函数 (Special Member Functions)
@@ -1522,6 +2443,158 @@ namespace Set
 	 */
 	ostream &operator<<(ostream &f, const Combinaison &c);
 
+	// ========================================================================
+	// 无分配渲染 (Allocation-free Rendering)
+	// ========================================================================
+
+	/**
+	 * TamponRendu: 把文本写入调用者提供的缓冲区（不分配内存）
+	 *
+	 * - 空间不够时截断并设置 deborde，不抛异常（与 snprintf 类似），
+	 *   调用者可以用更大的缓冲区重新渲染
+	 * - getTexte() 返回已写入的内容；不会自动添加 '\0'
+	 *
+	 * 使用示例（批量追踪时每行复用同一个缓冲区）：
+	 *   char buf[TAILLE_MAX_RENDU_PLATEAU];
+	 *   TamponRendu t(buf, sizeof buf);
+	 *   rendrePlateau(t, ids, n);
+	 *   fwrite(buf, 1, t.getTaille(), fichier);
+	 */
+	class TamponRendu
+	{
+	private:
+		char *debut;
+		size_t capacite;
+		size_t taille = 0;
+		bool deborde = false;
+
+	public:
+		TamponRendu(char *buf, size_t cap) : debut(buf), capacite(cap) {}
+
+		void ecrire(std::string_view s)
+		{
+			size_t n = s.size();
+			if (n > capacite - taille)
+			{
+				n = capacite - taille;
+				deborde = true;
+			}
+			for (size_t i = 0; i < n; i++)
+				debut[taille + i] = s[i];
+			taille += n;
+		}
+		void ecrire(char c)
+		{
+			if (taille < capacite)
+				debut[taille++] = c;
+			else
+				deborde = true;
+		}
+		/**
+		 * ecrireEntier: 非负整数的十进制表示
+		 */
+		void ecrireEntier(size_t x)
+		{
+			char chiffres[20];
+			size_t n = 0;
+			do
+			{
+				chiffres[n++] = char('0' + x % 10);
+				x /= 10;
+			} while (x);
+			while (n)
+				ecrire(chiffres[--n]);
+		}
+
+		void effacer()
+		{
+			taille = 0;
+			deborde = false;
+		}
+		size_t getTaille() const { return taille; }
+		bool aDeborde() const { return deborde; }
+		std::string_view getTexte() const { return std::string_view(debut, taille); }
+	};
+
+	/**
+	 * TEXTES_CARTES[id]: 每张卡的文本 "[CFNR]"（颜色、形状、数量、填充），编译期生成
+	 * 渲染一张卡就是复制 6 个字节
+	 */
+	inline constexpr size_t TAILLE_TEXTE_CARTE = 6;
+
+	constexpr std::array<std::array<char, TAILLE_TEXTE_CARTE>, config::NB_CARTES> genererTextesCartes()
+	{
+		std::array<std::array<char, TAILLE_TEXTE_CARTE>, config::NB_CARTES> t{};
+		for (size_t id = 0; id < config::NB_CARTES; id++)
+		{
+			t[id][0] = '[';
+			t[id][1] = GLYPHES_COULEUR[chiffre(CarteId(id), 0)][0];
+			t[id][2] = GLYPHES_FORME[chiffre(CarteId(id), 2)][0];
+			t[id][3] = GLYPHES_NOMBRE[chiffre(CarteId(id), 1)][0];
+			t[id][4] = GLYPHES_REMPLISSAGE[chiffre(CarteId(id), 3)][0];
+			t[id][5] = ']';
+		}
+		return t;
+	}
+
+	inline constexpr auto TEXTES_CARTES = genererTextesCartes();
+
+	/**
+	 * TAILLE_MAX_RENDU_PLATEAU: rendrePlateau 对任意桌面（最多 81 张）需要的最大字节数
+	 * 两条横线各 48 字节 + 每张卡 6 字节 + 每 3 张一个换行 + 开头的换行
+	 */
+	inline constexpr size_t TAILLE_MAX_RENDU_PLATEAU = 2 * 48 + config::NB_CARTES * (TAILLE_TEXTE_CARTE + 1) + 1;
+
+	/**
+	 * rendre: 文本格式，与原来的 operator<< 输出完全相同
+	 * - 卡牌："[RO1P]"
+	 * - 组合："[[RO1P] ; [MO2P] ; [VO3P]]"
+	 * rendrePlateau: 与 Plateau::print 相同的网格格式（每行 3 张）
+	 */
+	inline void rendre(TamponRendu &t, CarteId id)
+	{
+		t.ecrire(std::string_view(TEXTES_CARTES[id].data(), TAILLE_TEXTE_CARTE));
+	}
+	inline void rendre(TamponRendu &t, const Carte &c) { rendre(t, c.getId()); }
+	void rendre(TamponRendu &t, const Combinaison &c);
+	void rendrePlateau(TamponRendu &t, const CarteId *ids, size_t n);
+
+	/**
+	 * rendreJson: JSON 格式
+	 * - 卡牌：{"id":0,"couleur":"rouge","nombre":1,"forme":"ovale","remplissage":"plein"}
+	 * - 组合：三张卡组成的数组
+	 * - 桌面：所有卡组成的数组
+	 */
+	void rendreJson(TamponRendu &t, CarteId id);
+	inline void rendreJson(TamponRendu &t, const Carte &c) { rendreJson(t, c.getId()); }
+	void rendreJson(TamponRendu &t, const Combinaison &c);
+	void rendreJsonPlateau(TamponRendu &t, const CarteId *ids, size_t n);
+
+	// ========================================================================
+	// ObservateurControleur：游戏事件钩子 (Game Event Hook)
+	// ========================================================================
+
+	/**
+	 * ObservateurControleur: 接收 Controleur 每一次状态变化的接口（观察者模式）
+	 *
+	 * - piocher / ajouter: distribuer() 从牌堆抽出一张卡、放到桌面上
+	 * - reclamer / retirer: jouer() 接受一个 SET、把三张卡从桌面移走
+	 * - restaurer: restaurer() / annuler() 把状态整体替换为快照
+	 *
+	 * 用途：二进制对局日志（journal.h 中的 Journal）、统计、调试
+	 * 没有设置观察者时 Controleur 只多一次空指针判断
+	 */
+	class ObservateurControleur
+	{
+	public:
+		virtual ~ObservateurControleur() = default;
+		virtual void piocher(CarteId id) = 0;
+		virtual void ajouter(CarteId id) = 0;
+		virtual void retirer(CarteId id) = 0;
+		virtual void reclamer(const Triplet &t) = 0;
+		virtual void restaurer(const EtatJeu &e) = 0;
+	};
+
 	// ========================================================================
 	// Controleur 类：游戏控制器类 (Game Controller Class)
 	// ========================================================================
@@ -1622,6 +2695,27 @@ namespace Set
 		 */
 		Pioche *pioche;
 
+		/**
+		 * historique: 悔棋用的环形缓冲区，保存最近若干次修改前的状态快照
+		 * - 默认关闭（容量 0）：distribuer() / jouer() 不保存任何快照
+		 * - activerHistorique(n) 之后最多保留 n 个快照，满了覆盖最旧的一个，内存固定为 n * 120 字节
+		 * sommet: 下一个快照写入的位置
+		 * nbAnnulations: 缓冲区中有效快照的个数（<= historique.size()）
+		 */
+		std::vector<EtatJeu> historique;
+		size_t sommet = 0;
+		size_t nbAnnulations = 0;
+
+		/**
+		 * memoriser: 修改状态之前调用，悔棋关闭时什么都不做
+		 */
+		void memoriser();
+
+		/**
+		 * observateur: 事件钩子（不拥有，可以为 nullptr）
+		 */
+		ObservateurControleur *observateur = nullptr;
+
 	public:
 		// ====================================================================
 		// 构造函数 (Constructor)
@@ -1658,6 +2752,14 @@ namespace Set
 			pioche = new Pioche(jeu); // 动态创建牌堆
 		}
 
+		/**
+		 * 构造函数：指定随机种子，抽牌顺序可复现（用于回放、测试和多线程）
+		 */
+		explicit Controleur(std::uint64_t graine, std::uint64_t flux = 0) : jeu(Jeu::getInstance())
+		{
+			pioche = new Pioche(jeu, GenerateurAleatoire(graine, flux));
+		}
+
 		// ====================================================================
 		// 访问器方法 (Accessor Methods)
 		// ====================================================================
@@ -1697,10 +2799,61 @@ namespace Set
 		 * 2. 如果桌面 < 12，循环抽牌直到达到 12 或牌堆空
 		 * 3. 否则，只抽一张牌
 		 *
+		 * 异常：桌面会超过 PLATEAU_MAX_CARTES 张时（调用者在有 SET 时加牌），
+		 *       抽牌前抛出 SetException，状态不变
+		 *
 		 * 实现在 set.cpp 中
 		 */
 		void distribuer();
 
+		/**
+		 * jouer: 玩家选出一个 SET，把这三张卡从桌面移走
+		 *
+		 * 返回：true 表示合法（三张卡都在桌面上且构成 SET）；不合法时不修改状态
+		 * 注意：与原来一样，补牌由调用者再调用 distribuer() 完成
+		 */
+		bool jouer(const Combinaison &c);
+
+		// ====================================================================
+		// 快照与悔棋 (Snapshots and Undo)
+		// ====================================================================
+
+		/**
+		 * sauvegarder: 生成当前状态的快照 O(1)
+		 * restaurer: 恢复到某个快照（不影响悔棋栈）
+		 */
+		EtatJeu sauvegarder() const;
+		void restaurer(const EtatJeu &e);
+
+		/**
+		 * activerHistorique: 开启悔棋，最多保留最近 capacite 次操作（0 表示关闭）
+		 * 重新设置容量会清空已有的快照
+		 *
+		 * 默认关闭：自动对局、基准测试和日志生成不需要悔棋，也不应该每步多保存 120 字节
+		 */
+		void activerHistorique(size_t capacite);
+		size_t getCapaciteHistorique() const { return historique.size(); }
+
+		/**
+		 * annuler: 撤销最近一次 distribuer() 或 jouer()
+		 * 返回：false 表示没有可撤销的操作（悔棋未开启，或已撤销到缓冲区中最旧的快照）
+		 *
+		 * 实现：每次修改状态前把快照写入环形缓冲区，撤销时取回最近的一个并恢复
+		 */
+		bool annuler();
+		size_t getNbAnnulationsPossibles() const { return nbAnnulations; }
+
+		/**
+		 * getHash: 当前局面的 Zobrist 哈希，可作为置换表的键
+		 */
+		std::uint64_t getHash() const { return hashZobrist(plateau.getMasque(), pioche->getMasque()); }
+
+		/**
+		 * setObservateur: 设置事件钩子（nullptr 表示取消），调用者负责 o 的生命周期
+		 */
+		void setObservateur(ObservateurControleur *o) { observateur = o; }
+		ObservateurControleur *getObservateur() const { return observateur; }
+
 		// ====================================================================
 		// 析构函数 (Destructor)
 		// ====================================================================
@@ -0,0 +1,457 @@
+#ifndef _SET_GENERIQUE_H
+#define _SET_GENERIQUE_H
+
+#include "set.h"
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/**
+ * ============================================================================
+ * 通用 SET 引擎 (Compile-time Generic N-attribute / K-value Set Engine)
+ * ============================================================================
+ *
+ * 经典 SET：4 个特征，每个特征 3 种取值，81 张卡，3 张卡组成一个 SET。
+ * 这里把"特征数 N"和"取值数 K"做成模板参数，用同一套代码支持各种变体：
+ * - EspaceCartes<3, 3>: 初学者模式，27 张卡
+ * - EspaceCartes<4, 3>: 经典游戏（与 set.h 中的 Carte/Jeu 编号完全一致）
+ * - EspaceCartes<5, 3>: 5 个特征，243 张卡
+ * - EspaceCartes<4, 4>: 每个特征 4 种取值，一个 SET 由 4 张卡组成
+ * - EspaceProjectif<N>: "projective SET"，规则完全不同（见下文）
+ *
+ * 通用规则：K 张卡构成 SET ⇔ 每个特征上这 K 张卡要么全相同，要么全不同
+ * - 任意 K-1 张卡最多只能被一张卡补全（completer）
+ * - K = 3 时等价于"每一位数字之和 ≡ 0 (mod 3)"，补全的卡总是存在
+ *
+ * 性能：
+ * - 所有参数在编译期确定，循环次数是常量，编译器可以完全展开
+ * - Regles<4, 3> 是完全特化版本，直接查 set.h 的 TABLE_TROISIEME，
+ *   经典游戏走这个模板时与 Combinaison::estUnSet() 一样快
+ *
+ * set.h 中的 Carte / Jeu / Combinaison 保持不变，它们就是经典游戏的专用实现；
+ * 本文件的模板与它们使用相同的编号，可以互相转换（CarteId == EspaceCartes<4,3>::Id）。
+ */
+namespace Set
+{
+	// ========================================================================
+	// EspaceCartes：卡牌编号空间 (Card Id Space)
+	// ========================================================================
+
+	/**
+	 * EspaceCartes<N, K>: N 个特征、每个特征 K 种取值的卡牌空间
+	 * 编号方式与 CarteId 相同：第 0 个特征是最高位（K 进制）
+	 */
+	template <size_t N, size_t K>
+	struct EspaceCartes
+	{
+		static_assert(N >= 1 && K >= 2, "il faut au moins un attribut et deux valeurs");
+
+		static constexpr size_t puissance(size_t e)
+		{
+			size_t p = 1;
+			for (size_t i = 0; i < e; i++)
+				p *= K;
+			return p;
+		}
+
+		static constexpr size_t NB_ATTRIBUTS = N;
+		static constexpr size_t NB_VALEURS = K;
+		static constexpr size_t NB_CARTES = puissance(N);
+
+		// 编号类型：能装下就用 1 字节
+		using Id = std::conditional_t<(NB_CARTES <= 256), std::uint8_t, std::uint16_t>;
+
+		/**
+		 * chiffre: 第 attribut 个特征的取值（0..K-1）
+		 */
+		static constexpr unsigned chiffre(Id id, size_t attribut)
+		{
+			return unsigned(id / puissance(N - 1 - attribut) % K);
+		}
+
+		/**
+		 * composer: 由 N 个取值组成编号
+		 */
+		static constexpr Id composer(const std::array<unsigned, N> &chiffres)
+		{
+			size_t id = 0;
+			for (size_t a = 0; a < N; a++)
+				id = id * K + chiffres[a];
+			return Id(id);
+		}
+	};
+
+	// 经典游戏的编号必须与 set.h 一致
+	static_assert(EspaceCartes<4, 3>::NB_CARTES == config::NB_CARTES, "81 cartes");
+	static_assert(std::is_same<EspaceCartes<4, 3>::Id, CarteId>::value, "meme type d'id");
+
+	// ========================================================================
+	// Regles：SET 判断规则 (Set Rules)
+	// ========================================================================
+
+	/**
+	 * Regles<N, K>: 通用版本
+	 * - estUnSet(ids): ids[0..K) 这 K 张卡是否构成 SET
+	 * - completer(ids): 补全 ids[0..K-1) 的唯一卡牌；不存在时返回 NB_CARTES
+	 */
+	template <size_t N, size_t K>
+	struct Regles
+	{
+		using Espace = EspaceCartes<N, K>;
+		using Id = typename Espace::Id;
+
+		static constexpr bool estUnSet(const Id *ids)
+		{
+			for (size_t a = 0; a < N; a++)
+			{
+				// 记录这个特征上出现过哪些取值：只出现 1 种（全同）或 K 种（全异）才合法
+				unsigned vus = 0, nbVus = 0;
+				for (size_t i = 0; i < K; i++)
+				{
+					unsigned bit = 1u << Espace::chiffre(ids[i], a);
+					nbVus += (vus & bit) == 0;
+					vus |= bit;
+				}
+				if (nbVus != 1 && nbVus != K)
+					return false;
+			}
+			return true;
+		}
+
+		static constexpr size_t completer(const Id *ids)
+		{
+			std::array<unsigned, N> chiffres{};
+			for (size_t a = 0; a < N; a++)
+			{
+				unsigned vus = 0, nbVus = 0;
+				for (size_t i = 0; i + 1 < K; i++)
+				{
+					unsigned bit = 1u << Espace::chiffre(ids[i], a);
+					nbVus += (vus & bit) == 0;
+					vus |= bit;
+				}
+				if (nbVus == 1) // 全相同：第 K 张也取这个值
+					chiffres[a] = Espace::chiffre(ids[0], a);
+				else if (nbVus == K - 1) // 全不同：第 K 张取唯一缺少的值
+				{
+					unsigned v = 0;
+					while (vus & (1u << v))
+						v++;
+					chiffres[a] = v;
+				}
+				else
+					return Espace::NB_CARTES;
+			}
+			return Espace::composer(chiffres);
+		}
+	};
+
+	/**
+	 * Regles<N, 3>: 三值的偏特化——逐位 c = -(a + b) mod 3，补全的卡总是存在
+	 */
+	template <size_t N>
+	struct Regles<N, 3>
+	{
+		using Espace = EspaceCartes<N, 3>;
+		using Id = typename Espace::Id;
+
+		static constexpr Id troisieme(Id a, Id b)
+		{
+			std::array<unsigned, N> chiffres{};
+			for (size_t k = 0; k < N; k++)
+				chiffres[k] = (6 - Espace::chiffre(a, k) - Espace::chiffre(b, k)) % 3;
+			return Espace::composer(chiffres);
+		}
+		static constexpr size_t completer(const Id *ids) { return troisieme(ids[0], ids[1]); }
+		static constexpr bool estUnSet(const Id *ids) { return troisieme(ids[0], ids[1]) == ids[2]; }
+	};
+
+	/**
+	 * Regles<4, 3>: 经典游戏的完全特化——直接查 TABLE_TROISIEME（快速路径）
+	 */
+	template <>
+	struct Regles<4, 3>
+	{
+		using Espace = EspaceCartes<4, 3>;
+		using Id = CarteId;
+
+		static constexpr Id troisieme(Id a, Id b) { return Set::troisieme(a, b); }
+		static constexpr size_t completer(const Id *ids) { return Set::troisieme(ids[0], ids[1]); }
+		static constexpr bool estUnSet(const Id *ids) { return Set::estUnSet(ids[0], ids[1], ids[2]); }
+	};
+
+	// ========================================================================
+	// CarteGenerique / JeuGenerique / CombinaisonGenerique
+	// ========================================================================
+
+	template <size_t N, size_t K>
+	class JeuGenerique;
+
+	/**
+	 * CarteGenerique<N, K>: 一张卡牌，只保存编号
+	 * 与 Carte 一样，构造函数私有，只能由 JeuGenerique 创建
+	 */
+	template <size_t N, size_t K>
+	class CarteGenerique
+	{
+	public:
+		using Espace = EspaceCartes<N, K>;
+		using Id = typename Espace::Id;
+
+	private:
+		Id id;
+
+		constexpr explicit CarteGenerique(Id i) : id(i) {}
+
+		friend class JeuGenerique<N, K>;
+
+	public:
+		constexpr Id getId() const { return id; }
+
+		/**
+		 * getAttribut: 第 a 个特征的取值（0..K-1）
+		 */
+		constexpr unsigned getAttribut(size_t a) const { return Espace::chiffre(id, a); }
+	};
+
+	/**
+	 * 输出运算符：[取值 取值 ...]，例如 [0 2 1]
+	 */
+	template <size_t N, size_t K>
+	ostream &operator<<(ostream &f, const CarteGenerique<N, K> &c)
+	{
+		f << "[";
+		for (size_t a = 0; a < N; a++)
+			f << (a ? " " : "") << c.getAttribut(a);
+		f << "]";
+		return f;
+	}
+
+	/**
+	 * JeuGenerique<N, K>: 管理 K^N 张卡牌的单例（与 Jeu 相同的设计）
+	 * - 卡牌数组在编译期生成（constexpr），下标即编号
+	 * - 支持 range-based for：for (const auto &c : JeuGenerique<5, 3>::getInstance())
+	 */
+	template <size_t N, size_t K>
+	class JeuGenerique
+	{
+	public:
+		using Espace = EspaceCartes<N, K>;
+		using Carte = CarteGenerique<N, K>;
+		using Id = typename Espace::Id;
+
+	private:
+		template <size_t... I>
+		static constexpr std::array<Carte, Espace::NB_CARTES> genererCartes(std::index_sequence<I...>)
+		{
+			return {{Carte(Id(I))...}};
+		}
+
+		static constexpr std::array<Carte, Espace::NB_CARTES> cartes =
+			genererCartes(std::make_index_sequence<Espace::NB_CARTES>{});
+
+		JeuGenerique() = default;
+		JeuGenerique(const JeuGenerique &) = delete;
+		JeuGenerique &operator=(const JeuGenerique &) = delete;
+
+	public:
+		static JeuGenerique &getInstance()
+		{
+			static JeuGenerique instance;
+			return instance;
+		}
+
+		static constexpr size_t getNbCartes() { return Espace::NB_CARTES; }
+
+		const Carte &getCarte(size_t i) const
+		{
+			if (i >= Espace::NB_CARTES)
+				throw SetException("carte iexistante");
+			return cartes[i];
+		}
+
+		/**
+		 * getComplement: 补全 K-1 张卡的唯一卡牌；不存在时返回 nullptr
+		 */
+		const Carte *getComplement(const Id *ids) const
+		{
+			size_t c = Regles<N, K>::completer(ids);
+			return c < Espace::NB_CARTES ? &cartes[c] : nullptr;
+		}
+
+		using const_iterator = const Carte *;
+		const_iterator begin() const { return cartes.data(); }
+		const_iterator end() const { return cartes.data() + cartes.size(); }
+	};
+
+	/**
+	 * CombinaisonGenerique<N, K>: K 张卡的组合
+	 * 保存编号而不是指针，判断时直接调用 Regles<N, K>
+	 */
+	template <size_t N, size_t K>
+	class CombinaisonGenerique
+	{
+	public:
+		using Carte = CarteGenerique<N, K>;
+		using Id = typename EspaceCartes<N, K>::Id;
+
+	private:
+		std::array<Id, K> ids;
+
+	public:
+		template <typename... Cartes>
+		explicit CombinaisonGenerique(const Cartes &...c) : ids{{c.getId()...}}
+		{
+			static_assert(sizeof...(Cartes) == K, "une combinaison contient exactement K cartes");
+		}
+
+		const Carte &getCarte(size_t i) const { return JeuGenerique<N, K>::getInstance().getCarte(ids[i]); }
+
+		bool estUnSet() const { return Regles<N, K>::estUnSet(ids.data()); }
+	};
+
+	// ========================================================================
+	// 通用 SET 查找 (Generic Set Counting)
+	// ========================================================================
+
+	/**
+	 * compterSetsGenerique: 统计 ids[0..n) 中的 SET 个数
+	 *
+	 * 算法：枚举所有 K-1 张卡的组合（下标递增），用 completer 求补全的卡，
+	 *      再查位图看它是否在场；只有补全卡的编号大于这 K-1 张时才计数，避免重复
+	 * 复杂度：O(n^(K-1))，K = 3 时为 O(n²)
+	 *
+	 * 编译期分派（if constexpr）：
+	 * - 经典游戏 <4, 3> 直接调用 set.h 的 compterSets（与专用实现完全相同）
+	 * - 其它 K = 3 变体用无分支的双重循环：命中次数 / 3
+	 */
+	template <size_t N, size_t K>
+	size_t compterSetsGenerique(const typename EspaceCartes<N, K>::Id *ids, size_t n)
+	{
+		if constexpr (N == 4 && K == 3)
+			return compterSets(ids, n);
+
+		using Id = typename EspaceCartes<N, K>::Id;
+		std::bitset<EspaceCartes<N, K>::NB_CARTES> presentes;
+		for (size_t i = 0; i < n; i++)
+			presentes.set(ids[i]);
+
+		if constexpr (K == 3)
+		{
+			size_t nb = 0;
+			for (size_t i = 0; i < n; i++)
+				for (size_t j = i + 1; j < n; j++)
+					nb += presentes.test(Regles<N, 3>::troisieme(ids[i], ids[j]));
+			return nb / 3;
+		}
+
+		size_t nb = 0;
+		Id choisis[K];
+		size_t indices[K];
+		// 非递归地枚举 K-1 元组合：indices[0] < indices[1] < ... < indices[K-2]
+		size_t profondeur = 0;
+		indices[0] = 0;
+		while (true)
+		{
+			if (indices[profondeur] >= n)
+			{
+				if (profondeur == 0)
+					break;
+				indices[--profondeur]++;
+				continue;
+			}
+			choisis[profondeur] = ids[indices[profondeur]];
+			if (profondeur + 2 < K)
+			{
+				indices[profondeur + 1] = indices[profondeur] + 1;
+				profondeur++;
+				continue;
+			}
+			size_t c = Regles<N, K>::completer(choisis);
+			if (c < EspaceCartes<N, K>::NB_CARTES && presentes.test(c))
+			{
+				bool plusGrand = true;
+				for (size_t i = 0; i + 1 < K; i++)
+					plusGrand &= c > choisis[i];
+				nb += plusGrand;
+			}
+			indices[profondeur]++;
+		}
+		return nb;
+	}
+
+	// ========================================================================
+	// EspaceProjectif："projective SET" 变体 (Projective Set Variant)
+	// ========================================================================
+
+	/**
+	 * EspaceProjectif<N>: projective SET 的规则
+	 *
+	 * - 每张卡有 N 种颜色的点，每种颜色的点"有或没有"，至少有一个点
+	 *   所以卡牌就是 GF(2)^N 中的非零向量，编号 1..2^N-1，一共 2^N - 1 张（N = 6 时 63 张）
+	 * - 任意张数（至少一张）的卡，只要每种颜色的点数都是偶数，就构成一个 SET，
+	 *   即所有编号按位异或为 0
+	 * - 桌面上 n 张卡中 SET 的个数 = 2^(n - 秩) - 1（秩为这些向量在 GF(2) 上的秩）
+	 */
+	template <size_t N>
+	struct EspaceProjectif
+	{
+		static_assert(N >= 1 && N <= 16, "au plus 16 couleurs");
+
+		static constexpr size_t NB_CARTES = (size_t(1) << N) - 1;
+		using Id = std::conditional_t<(N <= 8), std::uint8_t, std::uint16_t>;
+
+		static constexpr bool estUnSet(const Id *ids, size_t k)
+		{
+			unsigned x = 0;
+			for (size_t i = 0; i < k; i++)
+				x ^= ids[i];
+			return k > 0 && x == 0;
+		}
+
+		/**
+		 * rang: 用高斯消元（线性基）求 ids[0..n) 在 GF(2) 上的秩
+		 */
+		static size_t rang(const Id *ids, size_t n)
+		{
+			unsigned base[N] = {};
+			size_t r = 0;
+			for (size_t i = 0; i < n; i++)
+			{
+				unsigned x = ids[i];
+				for (size_t b = N; b-- > 0 && x;)
+				{
+					if (!((x >> b) & 1))
+						continue;
+					if (!base[b])
+					{
+						base[b] = x;
+						r++;
+						x = 0;
+					}
+					else
+						x ^= base[b];
+				}
+			}
+			return r;
+		}
+
+		static size_t compterSets(const Id *ids, size_t n)
+		{
+			return (size_t(1) << (n - rang(ids, n))) - 1;
+		}
+	};
+
+	// ========================================================================
+	// 常用变体 (Common Variants)
+	// ========================================================================
+
+	using JeuDebutant = JeuGenerique<3, 3>;	 // 27 张卡，去掉"填充"特征
+	using JeuClassique = JeuGenerique<4, 3>; // 81 张卡，与 Jeu 编号一致
+	using JeuEtendu = JeuGenerique<5, 3>;	 // 243 张卡
+
+} // end of namespace Set
+
+#endif // _SET_GENERIQUE_H
@@ -0,0 +1,222 @@
+/**
+ * ============================================================================
+ * 批量 SET 判断实现文件 (SIMD Batch Set Validation Implementation)
+ * ============================================================================
+ */
+
+#include "setsimd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SET_LOT_X86 1
+#endif
+
+namespace Set
+{
+	void LotTriplets::reserver(size_t n)
+	{
+		for (auto &attribut : chiffres)
+			for (auto &voie : attribut)
+				voie.reserve(n);
+	}
+
+	void LotTriplets::vider()
+	{
+		for (auto &attribut : chiffres)
+			for (auto &voie : attribut)
+				voie.clear();
+	}
+
+	void LotTriplets::ajouter(CarteId a, CarteId b, CarteId c)
+	{
+		if (a >= config::NB_CARTES || b >= config::NB_CARTES || c >= config::NB_CARTES)
+			throw SetException("LotTriplets : carte inexistante");
+		for (size_t k = 0; k < config::NB_ATTRIBUTS; k++)
+		{
+			chiffres[k][0].push_back(std::uint8_t(chiffre(a, k)));
+			chiffres[k][1].push_back(std::uint8_t(chiffre(b, k)));
+			chiffres[k][2].push_back(std::uint8_t(chiffre(c, k)));
+		}
+	}
+
+	namespace
+	{
+		/**
+		 * Voies: 一批三元组的 12 条通道指针
+		 */
+		struct Voies
+		{
+			const std::uint8_t *v[config::NB_ATTRIBUTS][3];
+
+			explicit Voies(const LotTriplets &lot)
+			{
+				for (size_t k = 0; k < config::NB_ATTRIBUTS; k++)
+					for (size_t p = 0; p < 3; p++)
+						v[k][p] = lot.getChiffres(k, p);
+			}
+		};
+
+		std::uint8_t estUnSetScalaire(const Voies &voies, size_t i)
+		{
+			std::uint8_t ok = 1;
+			for (size_t k = 0; k < config::NB_ATTRIBUTS; k++)
+			{
+				std::uint8_t s = std::uint8_t(voies.v[k][0][i] + voies.v[k][1][i] + voies.v[k][2][i]);
+				ok &= std::uint8_t((s == 0) | (s == 3) | (s == 6));
+			}
+			return ok;
+		}
+
+		// 标量实现按固定大小的块处理：块内逐个特征扫一遍，循环次数是常量、没有依赖，
+		// 编译器在 -O2 下也会自动向量化（SSE2）；不足一块的尾部逐个处理
+		constexpr size_t TAILLE_BLOC = 256;
+
+		/**
+		 * validerBloc: ok[j] = 第 debut + j 个三元组是否为 SET（j < TAILLE_BLOC）
+		 */
+		void validerBloc(const Voies &voies, size_t debut, std::uint8_t *__restrict ok)
+		{
+			for (size_t j = 0; j < TAILLE_BLOC; j++)
+				ok[j] = 1;
+			for (size_t k = 0; k < config::NB_ATTRIBUTS; k++)
+			{
+				const std::uint8_t *__restrict a = voies.v[k][0] + debut;
+				const std::uint8_t *__restrict b = voies.v[k][1] + debut;
+				const std::uint8_t *__restrict c = voies.v[k][2] + debut;
+				for (size_t j = 0; j < TAILLE_BLOC; j++)
+				{
+					// 写成三个条件表达式而不是 (s == 0) | ...，后者在 GCC 中会提升为 int，阻止向量化
+					std::uint8_t s = std::uint8_t(a[j] + b[j] + c[j]);
+					std::uint8_t m = s == 0 ? 1 : 0;
+					m |= s == 3 ? 1 : 0;
+					m |= s == 6 ? 1 : 0;
+					ok[j] &= m;
+				}
+			}
+		}
+
+		void validerScalaire(const Voies &voies, size_t debut, size_t n, std::uint8_t *resultats)
+		{
+			size_t i = debut;
+			for (; i + TAILLE_BLOC <= n; i += TAILLE_BLOC)
+				validerBloc(voies, i, resultats + i);
+			for (; i < n; i++)
+				resultats[i] = estUnSetScalaire(voies, i);
+		}
+
+		size_t compterScalaire(const Voies &voies, size_t debut, size_t n)
+		{
+			std::uint8_t ok[TAILLE_BLOC];
+			size_t nb = 0, i = debut;
+			for (; i + TAILLE_BLOC <= n; i += TAILLE_BLOC)
+			{
+				validerBloc(voies, i, ok);
+				unsigned somme = 0;
+				for (size_t j = 0; j < TAILLE_BLOC; j++)
+					somme += ok[j];
+				nb += somme;
+			}
+			for (; i < n; i++)
+				nb += estUnSetScalaire(voies, i);
+			return nb;
+		}
+
+#ifdef SET_LOT_X86
+		/**
+		 * masqueAVX2: 第 i..i+31 个三元组的判断结果，每字节 0xFF（SET）或 0x00
+		 */
+		__attribute__((target("avx2"))) inline __m256i masqueAVX2(const Voies &voies, size_t i)
+		{
+			const __m256i trois = _mm256_set1_epi8(3);
+			const __m256i six = _mm256_set1_epi8(6);
+			__m256i ok = _mm256_set1_epi8(-1);
+			for (size_t k = 0; k < config::NB_ATTRIBUTS; k++)
+			{
+				__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(voies.v[k][0] + i));
+				__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(voies.v[k][1] + i));
+				__m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(voies.v[k][2] + i));
+				__m256i s = _mm256_add_epi8(_mm256_add_epi8(a, b), c);
+				__m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_setzero_si256()),
+											_mm256_or_si256(_mm256_cmpeq_epi8(s, trois), _mm256_cmpeq_epi8(s, six)));
+				ok = _mm256_and_si256(ok, m);
+			}
+			return ok;
+		}
+
+		__attribute__((target("avx2"))) void validerAVX2(const Voies &voies, size_t n, std::uint8_t *resultats)
+		{
+			const __m256i un = _mm256_set1_epi8(1);
+			size_t i = 0;
+			for (; i + 32 <= n; i += 32)
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(resultats + i),
+									_mm256_and_si256(masqueAVX2(voies, i), un));
+			validerScalaire(voies, i, n, resultats);
+		}
+
+		__attribute__((target("avx2"))) size_t compterAVX2(const Voies &voies, size_t n)
+		{
+			size_t nb = 0, i = 0;
+			for (; i + 32 <= n; i += 32)
+				nb += __builtin_popcount(unsigned(_mm256_movemask_epi8(masqueAVX2(voies, i))));
+			return nb + compterScalaire(voies, i, n);
+		}
+#endif
+
+		bool avx2Disponible()
+		{
+#ifdef SET_LOT_X86
+			static const bool disponible = __builtin_cpu_supports("avx2");
+			return disponible;
+#else
+			return false;
+#endif
+		}
+
+		void verifierImplementation(ImplementationLot impl)
+		{
+			if (impl == ImplementationLot::avx2 && !avx2Disponible())
+				throw SetException("validerLot : AVX2 non disponible sur ce processeur");
+		}
+	}
+
+	ImplementationLot getImplementationLot()
+	{
+		return avx2Disponible() ? ImplementationLot::avx2 : ImplementationLot::scalaire;
+	}
+
+	void validerLot(const LotTriplets &lot, std::uint8_t *resultats)
+	{
+		validerLot(lot, resultats, getImplementationLot());
+	}
+
+	void validerLot(const LotTriplets &lot, std::uint8_t *resultats, ImplementationLot impl)
+	{
+		verifierImplementation(impl);
+		Voies voies(lot);
+#ifdef SET_LOT_X86
+		if (impl == ImplementationLot::avx2)
+		{
+			validerAVX2(voies, lot.getTaille(), resultats);
+			return;
+		}
+#endif
+		validerScalaire(voies, 0, lot.getTaille(), resultats);
+	}
+
+	size_t compterSetsLot(const LotTriplets &lot)
+	{
+		return compterSetsLot(lot, getImplementationLot());
+	}
+
+	size_t compterSetsLot(const LotTriplets &lot, ImplementationLot impl)
+	{
+		verifierImplementation(impl);
+		Voies voies(lot);
+#ifdef SET_LOT_X86
+		if (impl == ImplementationLot::avx2)
+			return compterAVX2(voies, lot.getTaille());
+#endif
+		return compterScalaire(voies, 0, lot.getTaille());
+	}
+
+} // end of namespace Set
@@ -0,0 +1,80 @@
+#ifndef _SETSIMD_H
+#define _SETSIMD_H
+
+#include "set.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * ============================================================================
+ * 批量 SET 判断 (SIMD Batch Set Validation)
+ * ============================================================================
+ *
+ * 问题：离线分析时要判断海量的候选三元组，逐个调用 Combinaison::estUnSet()
+ * 每次都要解引用三个指针、查一次表，编译器无法向量化
+ *
+ * 做法：结构体数组 (AoS) -> 数组结构体 (SoA)
+ * - 每个特征、每个位置（第 1/2/3 张卡）一条"通道"：chiffres[attribut][position][i]
+ * - 第 i 个三元组是 SET <=> 对每个特征，三张卡的三进制数字之和 ≡ 0 (mod 3)
+ * - 三个数字之和只可能是 0..6，所以只需判断和是否为 0、3 或 6
+ *
+ * 实现：
+ * - AVX2：一次处理 32 个三元组（每个数字占一个字节，一个 256 位寄存器 32 个）
+ * - 标量：同样的公式逐个计算，没有分支
+ * - 运行时用 __builtin_cpu_supports("avx2") 选择，只选一次；
+ *   AVX2 版本用 __attribute__((target("avx2"))) 单独编译，不需要 -mavx2
+ */
+namespace Set
+{
+	/**
+	 * LotTriplets: SoA 格式的一批三元组
+	 */
+	class LotTriplets
+	{
+	private:
+		std::vector<std::uint8_t> chiffres[config::NB_ATTRIBUTS][3];
+
+	public:
+		size_t getTaille() const { return chiffres[0][0].size(); }
+		const std::uint8_t *getChiffres(size_t attribut, size_t position) const { return chiffres[attribut][position].data(); }
+
+		void reserver(size_t n);
+		void vider();
+
+		/**
+		 * ajouter: 追加一个三元组（不要求是 SET，也不要求排好序）
+		 */
+		void ajouter(CarteId a, CarteId b, CarteId c);
+		void ajouter(const Triplet &t) { ajouter(t.a, t.b, t.c); }
+	};
+
+	enum class ImplementationLot
+	{
+		scalaire,
+		avx2
+	};
+
+	/**
+	 * getImplementationLot: 当前 CPU 上 validerLot 使用的实现
+	 */
+	ImplementationLot getImplementationLot();
+
+	/**
+	 * validerLot: resultats[i] = 1 表示第 i 个三元组是 SET，否则为 0
+	 * resultats 至少要有 lot.getTaille() 个字节
+	 *
+	 * 带 impl 参数的版本强制使用指定实现（用于测试和性能对比），
+	 * 当前 CPU 不支持该实现时抛出 SetException
+	 */
+	void validerLot(const LotTriplets &lot, std::uint8_t *resultats);
+	void validerLot(const LotTriplets &lot, std::uint8_t *resultats, ImplementationLot impl);
+
+	/**
+	 * compterSetsLot: 这一批中 SET 的个数（不写出逐个结果）
+	 */
+	size_t compterSetsLot(const LotTriplets &lot);
+	size_t compterSetsLot(const LotTriplets &lot, ImplementationLot impl);
+
+} // end of namespace Set
+
+#endif // _SETSIMD_H
@@ -0,0 +1,157 @@
+/**
+ * ============================================================================
+ * 蒙特卡洛模拟实现文件 (Monte Carlo Simulation Implementation)
+ * ============================================================================
+ */
+
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace Set
+{
+	void StatistiquesSimulation::fusionner(const StatistiquesSimulation &s)
+	{
+		nbParties += s.nbParties;
+		nbDistributions += s.nbDistributions;
+		nbPlateauxSansSet += s.nbPlateauxSansSet;
+		for (size_t i = 0; i < setsParPartie.size(); i++)
+			setsParPartie[i] += s.setsParPartie[i];
+		for (size_t i = 0; i < cartesRestantes.size(); i++)
+			cartesRestantes[i] += s.cartesRestantes[i];
+	}
+
+	double StatistiquesSimulation::probaSansSet() const
+	{
+		return nbDistributions ? double(nbPlateauxSansSet) / nbDistributions : 0;
+	}
+
+	double StatistiquesSimulation::setsMoyensParPartie() const
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < setsParPartie.size(); i++)
+			total += i * setsParPartie[i];
+		return nbParties ? double(total) / nbParties : 0;
+	}
+
+	double StatistiquesSimulation::partiesParSeconde() const
+	{
+		return dureeSecondes > 0 ? nbParties / dureeSecondes : 0;
+	}
+
+	/**
+	 * simulerPartie: 模拟一局完整的对局，结果累加到 stats
+	 *
+	 * 状态全部放在栈上：
+	 * - pioche: 剩余卡牌编号，抽牌方式与 Pioche::piocher() 相同（随机位置，用最后一张填补）
+	 * - plateau: Plateau（卡牌编号存放在对象内部），O(1) 移除卡牌
+	 */
+	static void simulerPartie(GenerateurAleatoire &rng, StatistiquesSimulation &stats)
+	{
+		CarteId pioche[config::NB_CARTES];
+		Plateau plateau;
+		size_t nbPioche = config::NB_CARTES;
+		for (size_t i = 0; i < config::NB_CARTES; i++)
+			pioche[i] = static_cast<CarteId>(i);
+
+		auto piocher = [&]()
+		{
+			size_t i = rng.borne(std::uint32_t(nbPioche));
+			CarteId c = pioche[i];
+			pioche[i] = pioche[--nbPioche];
+			plateau.ajouter(c);
+		};
+		// 与 Controleur::distribuer() 相同的规则
+		auto distribuer = [&]()
+		{
+			if (nbPioche > 0)
+				piocher();
+			while (nbPioche > 0 && plateau.getNbCartes() < config::PLATEAU_MIN_CARTES)
+				piocher();
+		};
+
+		size_t nbSets = 0;
+		distribuer();
+		while (true)
+		{
+			stats.nbDistributions++;
+			Triplet t;
+			if (trouverUnSet(plateau.getIds(), plateau.getNbCartes(), t))
+			{
+				plateau.retirer(t.a);
+				plateau.retirer(t.b);
+				plateau.retirer(t.c);
+				nbSets++;
+				distribuer();
+			}
+			else
+			{
+				stats.nbPlateauxSansSet++;
+				if (nbPioche == 0)
+					break;
+				distribuer();
+			}
+		}
+
+		stats.nbParties++;
+		stats.setsParPartie[nbSets]++;
+		stats.cartesRestantes[plateau.getNbCartes()]++;
+	}
+
+	StatistiquesSimulation Simulateur::lancer() const
+	{
+		unsigned nbThreads = parametres.nbThreads;
+		if (nbThreads == 0)
+			nbThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		// 每个线程一份统计，互不干扰，最后再合并
+		std::vector<StatistiquesSimulation> partielles(nbThreads);
+		std::vector<std::thread> threads;
+
+		auto debut = std::chrono::steady_clock::now();
+		for (unsigned t = 0; t < nbThreads; t++)
+		{
+			// 静态划分：线程 t 负责 [premier, dernier) 这些对局
+			size_t premier = parametres.nbParties * t / nbThreads;
+			size_t dernier = parametres.nbParties * (t + 1) / nbThreads;
+			threads.emplace_back([this, t, premier, dernier, &partielles]()
+								 {
+				for (size_t i = premier; i < dernier; i++)
+				{
+					// 每局一个独立的随机流：同一个 graine，流编号为对局的全局编号，结果与线程数无关
+					GenerateurAleatoire rng(parametres.graine, i);
+					simulerPartie(rng, partielles[t]);
+				} });
+		}
+		for (std::thread &th : threads)
+			th.join();
+		auto fin = std::chrono::steady_clock::now();
+
+		StatistiquesSimulation total;
+		for (const StatistiquesSimulation &s : partielles)
+			total.fusionner(s);
+		total.dureeSecondes = std::chrono::duration<double>(fin - debut).count();
+		return total;
+	}
+
+	ostream &operator<<(ostream &f, const StatistiquesSimulation &s)
+	{
+		f << "parties simulees      : " << s.nbParties << "\n";
+		f << "P(plateau sans set)   : " << s.probaSansSet()
+		  << " (" << s.nbPlateauxSansSet << " / " << s.nbDistributions << ")\n";
+		f << "sets par partie       : " << s.setsMoyensParPartie() << " en moyenne\n";
+		for (size_t i = 0; i < s.setsParPartie.size(); i++)
+			if (s.setsParPartie[i])
+				f << "  " << i << " sets : " << s.setsParPartie[i] << "\n";
+		f << "cartes restantes en fin de partie :\n";
+		for (size_t i = 0; i < s.cartesRestantes.size(); i++)
+			if (s.cartesRestantes[i])
+				f << "  " << i << " cartes : " << s.cartesRestantes[i] << "\n";
+		f << "debit                 : " << s.partiesParSeconde() << " parties/s ("
+		  << s.dureeSecondes << " s)\n";
+		return f;
+	}
+
+} // end of namespace Set
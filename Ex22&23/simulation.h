@@ -0,0 +1,103 @@
+#ifndef _SIMULATION_H
+#define _SIMULATION_H
+
+#include "set.h"
+#include <array>
+#include <cstdint>
+
+/**
+ * ============================================================================
+ * 蒙特卡洛模拟 (Headless Monte Carlo Simulation)
+ * ============================================================================
+ *
+ * 目的：大量模拟完整的 SET 对局，统计发牌相关的概率：
+ * - 桌面上没有 SET 的概率
+ * - 一局平均能拿到多少个 SET（对局长度）
+ * - 对局结束时桌面上剩余的卡牌数
+ *
+ * 为什么不直接用 Controleur？
+ * - Controleur 依赖 Jeu 单例和堆上的 Pioche，桌面和牌堆都是指针数组
+ * - 模拟只需要卡牌编号，全部放在栈上，省掉堆分配和指针解引用
+ *
+ * 这里的做法：
+ * - 每局对局的状态（牌堆、桌面）都是线程私有的卡牌编号数组
+ * - 每个线程有自己的 GenerateurAleatoire（同一个种子、不同的流编号）
+ * - 每个线程先统计到自己的直方图，最后再合并，线程之间没有共享写
+ *
+ * 发牌规则与 Controleur::distribuer() 完全一致：
+ * - 先补一张牌，再补到 12 张
+ * - 桌面上有 SET 就拿走第一个找到的 SET，然后重新发牌
+ * - 没有 SET 且牌堆为空时对局结束
+ */
+namespace Set
+{
+	/**
+	 * StatistiquesSimulation: 模拟结果（可合并的计数器和直方图）
+	 */
+	struct StatistiquesSimulation
+	{
+		// 一局最多拿走 81 / 3 = 27 个 SET
+		static constexpr size_t MAX_SETS = config::NB_CARTES / 3;
+
+		size_t nbParties = 0;		   // 模拟的对局数
+		size_t nbDistributions = 0;	   // 发牌后检查桌面的次数
+		size_t nbPlateauxSansSet = 0;  // 其中桌面上没有 SET 的次数
+		std::array<size_t, MAX_SETS + 1> setsParPartie{};		 // 每局拿到的 SET 数 -> 对局数
+		std::array<size_t, config::NB_CARTES + 1> cartesRestantes{}; // 结束时桌面剩余卡牌数 -> 对局数
+		double dureeSecondes = 0;	   // 总耗时（墙上时间）
+
+		/**
+		 * fusionner: 把另一个线程的统计结果合并进来
+		 */
+		void fusionner(const StatistiquesSimulation &s);
+
+		double probaSansSet() const;
+		double setsMoyensParPartie() const;
+		double partiesParSeconde() const;
+	};
+
+	/**
+	 * ParametresSimulation: 模拟参数
+	 * - nbThreads == 0 表示使用所有核心（std::thread::hardware_concurrency）
+	 * - 第 i 局使用随机流 GenerateurAleatoire(graine, i)：相同的 graine 得到完全相同的结果，与线程数和机器无关
+	 */
+	struct ParametresSimulation
+	{
+		size_t nbParties = 100000;
+		unsigned nbThreads = 0;
+		std::uint64_t graine = 1;
+	};
+
+	/**
+	 * Simulateur: 多线程运行互相独立的对局
+	 *
+	 * 使用示例：
+	 *   ParametresSimulation p;
+	 *   p.nbParties = 1000000;
+	 *   StatistiquesSimulation s = Simulateur(p).lancer();
+	 *   cout << s;
+	 */
+	class Simulateur
+	{
+	private:
+		ParametresSimulation parametres;
+
+	public:
+		explicit Simulateur(const ParametresSimulation &p) : parametres(p) {}
+
+		/**
+		 * lancer: 把对局平均分给各个线程，等待全部完成后合并统计
+		 */
+		StatistiquesSimulation lancer() const;
+
+		const ParametresSimulation &getParametres() const { return parametres; }
+	};
+
+	/**
+	 * 输出运算符重载：打印概率、平均值、直方图和吞吐量
+	 */
+	ostream &operator<<(ostream &f, const StatistiquesSimulation &s);
+
+} // end of namespace Set
+
+#endif // _SIMULATION_H
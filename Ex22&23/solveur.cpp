@@ -0,0 +1,519 @@
+/**
+ * ============================================================================
+ * 残局求解器实现文件 (Endgame Solver Implementation)
+ * ============================================================================
+ */
+
+#include "solveur.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Set
+{
+	namespace
+	{
+		/**
+		 * Etat: 搜索中的一个局面（轮到玩家选 SET 之前）
+		 */
+		struct Etat
+		{
+			MasqueCartes plateau;
+			MasqueCartes pioche;
+
+			bool operator==(const Etat &e) const { return plateau == e.plateau && pioche == e.pioche; }
+		};
+
+		struct HashEtat
+		{
+			size_t operator()(const Etat &e) const
+			{
+				// 四个 64 位字各乘一个奇数常数后混合（splitmix64 的收尾步骤）
+				std::uint64_t h = e.plateau.mots[0] * 0x9E3779B97F4A7C15ULL;
+				h ^= e.plateau.mots[1] * 0xC2B2AE3D27D4EB4FULL;
+				h ^= e.pioche.mots[0] * 0x165667B19E3779F9ULL;
+				h ^= e.pioche.mots[1] * 0xD6E8FEB86659FD93ULL;
+				h ^= h >> 31;
+				h *= 0xBF58476D1CE4E5B9ULL;
+				return size_t(h ^ (h >> 29));
+			}
+		};
+
+		/**
+		 * Memoire: 多线程共享的记忆表
+		 * 按哈希值分成 NB_SHARDS 片，每片一把锁，不同线程大多落在不同的片上
+		 * 每个局面先登记为"计算中"：另一个线程遇到它时等待结果，而不是重复计算整棵子树
+		 * 等待不会死锁：线程 A 在算 X 时等 Y，说明 Y 是 X 的后继（卡牌更少），等待链上的局面严格变小，不可能成环
+		 */
+		class Memoire
+		{
+		private:
+			static constexpr size_t NB_SHARDS = 64;
+			struct Entree
+			{
+				ResultatFinDePartie r;
+				bool fini = false;
+			};
+			struct Shard
+			{
+				std::mutex verrou;
+				std::condition_variable fin;
+				std::unordered_map<Etat, Entree, HashEtat> table;
+			};
+			Shard shards[NB_SHARDS];
+
+			Shard &shard(size_t h) { return shards[h % NB_SHARDS]; }
+
+		public:
+			/**
+			 * reserver: 已有结果时写入 r 并返回 true（另一个线程正在计算时先等它算完）
+			 * 否则把 e 登记为"计算中"并返回 false，调用者计算后必须调用 publier
+			 */
+			bool reserver(const Etat &e, size_t h, ResultatFinDePartie &r)
+			{
+				Shard &s = shard(h);
+				std::unique_lock<std::mutex> verrou(s.verrou);
+				auto res = s.table.try_emplace(e);
+				if (res.second)
+					return false;
+				Entree &x = res.first->second; // rehash 不会使元素的引用失效
+				s.fin.wait(verrou, [&]()
+						   { return x.fini; });
+				r = x.r;
+				return true;
+			}
+			void publier(const Etat &e, size_t h, const ResultatFinDePartie &r)
+			{
+				Shard &s = shard(h);
+				{
+					std::lock_guard<std::mutex> verrou(s.verrou);
+					Entree &x = s.table[e];
+					x.r = r;
+					x.fini = true;
+				}
+				s.fin.notify_all();
+			}
+			size_t getNbEtats()
+			{
+				size_t n = 0;
+				for (Shard &s : shards)
+				{
+					std::lock_guard<std::mutex> verrou(s.verrou);
+					n += s.table.size();
+				}
+				return n;
+			}
+		};
+
+		/**
+		 * nbATirer: distribuer() 一次发几张牌（先补一张，再补到 12 张）
+		 */
+		size_t nbATirer(size_t nbPlateau, size_t nbPioche)
+		{
+			size_t k = nbPlateau + 1 < config::PLATEAU_MIN_CARTES ? config::PLATEAU_MIN_CARTES - nbPlateau : 1;
+			return std::min(k, nbPioche);
+		}
+
+		/**
+		 * pourChaqueTirage: 对从 pioche 中抽 k 张的每一种组合调用f(plateau', pioche')
+		 * 按组合（下标递增）枚举，每种结果只出现一次
+		 */
+		template <typename F>
+		void pourChaqueTirage(const MasqueCartes &plateau, const MasqueCartes &pioche, size_t k, F f)
+		{
+			CarteId ids[config::NB_CARTES];
+			size_t n = 0;
+			pioche.pourChaque([&](CarteId id)
+							  { ids[n++] = id; });
+
+			size_t choix[config::NB_CARTES];
+			for (size_t i = 0; i < k; i++)
+				choix[i] = i;
+			while (true)
+			{
+				Etat e{plateau, pioche};
+				for (size_t i = 0; i < k; i++)
+				{
+					e.plateau.ajouter(ids[choix[i]]);
+					e.pioche.retirer(ids[choix[i]]);
+				}
+				f(e);
+
+				// 下一个组合：找到最右边还能加一的位置
+				size_t i = k;
+				while (i > 0 && choix[i - 1] == n - k + i - 1)
+					i--;
+				if (i == 0)
+					return;
+				choix[i - 1]++;
+				for (size_t j = i; j < k; j++)
+					choix[j] = choix[j - 1] + 1;
+			}
+		}
+
+		/**
+		 * pourChaqueSet: 对桌面上的每个 SET 调用 f(plateau 去掉该 SET 后的掩码)
+		 * @return 桌面上是否有 SET
+		 */
+		template <typename F>
+		bool pourChaqueSet(const MasqueCartes &plateau, F f)
+		{
+			CarteId ids[config::NB_CARTES];
+			size_t n = 0;
+			plateau.pourChaque([&](CarteId id)
+							   { ids[n++] = id; });
+			// 与 trouverSets 相同：每个 SET 只在 z 为三者中最大编号时计入一次
+			bool trouve = false;
+			for (size_t i = 0; i < n; i++)
+				for (size_t j = i + 1; j < n; j++)
+				{
+					CarteId z = troisieme(ids[i], ids[j]);
+					if (z > ids[j] && plateau.contient(z))
+					{
+						trouve = true;
+						MasqueCartes reste = plateau;
+						reste.retirer(ids[i]);
+						reste.retirer(ids[j]);
+						reste.retirer(z);
+						if (!f(reste))
+							return true;
+					}
+				}
+			return trouve;
+		}
+
+		/**
+		 * pourChaqueSuccesseur: 对 e 的每个子局面（选择 SET + 发牌结果；没有 SET 时只有发牌结果）调用 f(e')
+		 * 与 Recherche::evaluer 访问的子局面相同
+		 */
+		template <typename F>
+		void pourChaqueSuccesseur(const Etat &e, F f)
+		{
+			auto tirages = [&](const MasqueCartes &p)
+			{
+				if (e.pioche.estVide())
+					f(Etat{p, e.pioche});
+				else
+					pourChaqueTirage(p, e.pioche, nbATirer(p.getNbCartes(), e.pioche.getNbCartes()), [&](const Etat &x)
+									 { f(x); });
+			};
+			bool aUnSet = pourChaqueSet(e.plateau, [&](const MasqueCartes &reste)
+										{ tirages(reste); return true; });
+			if (!aUnSet && !e.pioche.estVide())
+				tirages(e.plateau);
+		}
+
+		/**
+		 * Recherche: expectimax 搜索，所有线程共用一个实例
+		 */
+		class Recherche
+		{
+		private:
+			Memoire memoire;
+
+		public:
+			ResultatFinDePartie evaluer(const Etat &e);
+			ResultatFinDePartie distribuer(const MasqueCartes &plateau, const MasqueCartes &pioche);
+			size_t getNbEtats() { return memoire.getNbEtats(); }
+		};
+
+		/**
+		 * distribuer: 机会节点，对所有发牌结果取平均（maxSets 取最大）
+		 */
+		ResultatFinDePartie Recherche::distribuer(const MasqueCartes &plateau, const MasqueCartes &pioche)
+		{
+			if (pioche.estVide())
+				return evaluer(Etat{plateau, pioche});
+
+			ResultatFinDePartie r;
+			size_t nb = 0;
+			pourChaqueTirage(plateau, pioche, nbATirer(plateau.getNbCartes(), pioche.getNbCartes()),
+							 [&](const Etat &e)
+							 {
+								 ResultatFinDePartie s = evaluer(e);
+								 r.esperanceSets += s.esperanceSets;
+								 r.probaVider += s.probaVider;
+								 r.maxSets = std::max(r.maxSets, s.maxSets);
+								 nb++;
+							 });
+			r.esperanceSets /= nb;
+			r.probaVider /= nb;
+			return r;
+		}
+
+		/**
+		 * evaluer: 决策节点，对桌面上的每个 SET 取最大值
+		 */
+		ResultatFinDePartie Recherche::evaluer(const Etat &e)
+		{
+			size_t h = HashEtat()(e);
+			ResultatFinDePartie r;
+			if (memoire.reserver(e, h, r))
+				return r;
+
+			bool aUnSet = pourChaqueSet(e.plateau, [&](const MasqueCartes &reste)
+										{
+				ResultatFinDePartie s = distribuer(reste, e.pioche);
+				r.esperanceSets = std::max(r.esperanceSets, 1 + s.esperanceSets);
+				r.probaVider = std::max(r.probaVider, s.probaVider);
+				r.maxSets = std::max(r.maxSets, 1 + s.maxSets);
+				// 上界：这个选择一定能拿完所有卡牌，其它选择不可能更好
+				return s.probaVider < 1.0; });
+
+			if (!aUnSet)
+			{
+				if (e.pioche.estVide())
+					r.probaVider = e.plateau.estVide() ? 1.0 : 0.0;
+				else
+					r = distribuer(e.plateau, e.pioche);
+			}
+			memoire.publier(e, h, r);
+			return r;
+		}
+
+		/**
+		 * Noeud: 拆成任务的局面，所有子局面都算完后再汇总
+		 */
+		struct Noeud
+		{
+			Etat etat;
+			std::atomic<size_t> restants{1}; // 尚未算完的子局面数，登记子局面期间另加 1
+			std::vector<Noeud *> parents;	 // 等这个局面算完的父节点（由 Ordonnanceur 的锁保护）
+			bool fini = false;
+
+			explicit Noeud(const Etat &e) : etat(e) {}
+		};
+
+		/**
+		 * Tache: noeud 不为空时展开这个局面（子局面再作为任务）；否则串行求解 etat，完成后通知 parent
+		 */
+		struct Tache
+		{
+			Etat etat;
+			Noeud *noeud = nullptr;
+			Noeud *parent = nullptr;
+		};
+
+		/**
+		 * FileVolable: 一个线程的任务队列
+		 * 自己从尾部取（后进先出，深度优先），其它线程从头部偷（先进先出，偷到的是较早生成、通常较大的任务）
+		 */
+		class FileVolable
+		{
+		private:
+			std::mutex verrou;
+			std::deque<Tache> taches;
+
+		public:
+			void ajouter(const Tache &x)
+			{
+				std::lock_guard<std::mutex> v(verrou);
+				taches.push_back(x);
+			}
+			bool prendre(Tache &x)
+			{
+				std::lock_guard<std::mutex> v(verrou);
+				if (taches.empty())
+					return false;
+				x = taches.back();
+				taches.pop_back();
+				return true;
+			}
+			bool voler(Tache &x)
+			{
+				std::lock_guard<std::mutex> v(verrou);
+				if (taches.empty())
+					return false;
+				x = taches.front();
+				taches.pop_front();
+				return true;
+			}
+		};
+
+		/**
+		 * ECART_TACHES: 牌堆比根节点少不超过这么多张的局面拆成任务（Noeud），更小的局面在一个任务内串行求解
+		 * 用牌堆张数而不是深度作界限：同一个局面无论从哪条路径到达，是否拆分都一样
+		 */
+		constexpr size_t ECART_TACHES = 3;
+
+		/**
+		 * Ordonnanceur: 任务调度
+		 * - 展开一个 Noeud 时，子局面作为任务压入当前线程的队列；空闲线程从别的队列偷，因此深层的子树也能分给多个线程
+		 * - 线程从不阻塞等待子任务：最后一个完成的子任务负责汇总父节点（此时子局面都已在记忆表中），再逐层向上通知
+		 * - 同一个 Noeud 只展开一次：其它父节点只登记为等待者
+		 */
+		class Ordonnanceur
+		{
+		private:
+			Recherche &recherche;
+			std::vector<FileVolable> files;
+			size_t seuilPioche;
+			Noeud *racine = nullptr;
+			std::mutex verrou;
+			std::unordered_map<Etat, std::unique_ptr<Noeud>, HashEtat> noeuds;
+			std::atomic<bool> termine{false};
+			std::atomic<size_t> nbTaches{0};
+			std::atomic<size_t> nbVols{0};
+
+			void ajouter(unsigned t, const Tache &x)
+			{
+				nbTaches++;
+				files[t].ajouter(x);
+			}
+
+			void notifier(Noeud *n)
+			{
+				if (--n->restants == 0)
+					terminer(n);
+			}
+
+			// terminer: 汇总 n（子局面都已在记忆表中），然后通知等待 n 的父节点
+			void terminer(Noeud *n)
+			{
+				recherche.evaluer(n->etat);
+				std::vector<Noeud *> parents;
+				{
+					std::lock_guard<std::mutex> v(verrou);
+					n->fini = true;
+					parents.swap(n->parents);
+				}
+				if (n == racine)
+					termine = true;
+				for (Noeud *p : parents)
+					notifier(p);
+			}
+
+			// developper: 登记 n 的所有子局面，新的子局面作为任务压入线程 t 的队列
+			void developper(Noeud *n, unsigned t)
+			{
+				pourChaqueSuccesseur(n->etat, [&](const Etat &e)
+									 {
+					if (e.pioche.estVide() || e.pioche.getNbCartes() < seuilPioche)
+					{
+						n->restants++;
+						ajouter(t, Tache{e, nullptr, n});
+						return;
+					}
+					Noeud *m;
+					bool nouveau = false;
+					{
+						std::lock_guard<std::mutex> v(verrou);
+						std::unique_ptr<Noeud> &p = noeuds[e];
+						if (!p)
+						{
+							p.reset(new Noeud(e));
+							nouveau = true;
+						}
+						m = p.get();
+						if (m->fini)
+							return;
+						m->parents.push_back(n);
+						n->restants++;
+					}
+					if (nouveau)
+						ajouter(t, Tache{e, m, nullptr}); });
+				notifier(n);
+			}
+
+			void executer(const Tache &x, unsigned t)
+			{
+				if (x.noeud)
+					developper(x.noeud, t);
+				else
+				{
+					recherche.evaluer(x.etat);
+					notifier(x.parent);
+				}
+			}
+
+		public:
+			Ordonnanceur(Recherche &r, unsigned nbThreads, const Etat &e)
+				: recherche(r), files(nbThreads),
+				  seuilPioche(e.pioche.getNbCartes() > ECART_TACHES ? e.pioche.getNbCartes() - ECART_TACHES : 0)
+			{
+				std::unique_ptr<Noeud> &p = noeuds[e];
+				p.reset(new Noeud(e));
+				racine = p.get();
+				ajouter(0, Tache{e, racine, nullptr});
+			}
+
+			// travailler: 线程 t 的主循环：先做自己的任务，没有了就去偷，直到根节点汇总完毕
+			void travailler(unsigned t)
+			{
+				const size_t n = files.size();
+				Tache x;
+				while (!termine)
+				{
+					if (files[t].prendre(x))
+					{
+						executer(x, t);
+						continue;
+					}
+					bool vole = false;
+					for (size_t i = 1; i < n && !vole; i++)
+						vole = files[(t + i) % n].voler(x);
+					if (vole)
+					{
+						nbVols++;
+						executer(x, t);
+					}
+					else
+						std::this_thread::yield();
+				}
+			}
+
+			size_t getNbTaches() const { return nbTaches; }
+			size_t getNbVols() const { return nbVols; }
+		};
+	}
+
+	SolveurFinDePartie::SolveurFinDePartie(const MasqueCartes &p, const MasqueCartes &q, unsigned n)
+		: plateau(p), pioche(q), nbThreads(n)
+	{
+		if (pioche.getNbCartes() > MAX_PIOCHE)
+			throw SetException("SolveurFinDePartie : pioche trop grande");
+		if ((plateau.mots[0] & pioche.mots[0]) | (plateau.mots[1] & pioche.mots[1]))
+			throw SetException("SolveurFinDePartie : carte a la fois sur le plateau et dans la pioche");
+		if (nbThreads == 0)
+			nbThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	ResultatFinDePartie SolveurFinDePartie::resoudre()
+	{
+		auto debut = std::chrono::steady_clock::now();
+		Recherche recherche;
+
+		// 各线程从根节点开始展开、执行、偷取任务，直到根节点汇总完毕
+		Etat racine{plateau, pioche};
+		Ordonnanceur ordonnanceur(recherche, nbThreads, racine);
+		std::vector<std::thread> threads;
+		for (unsigned t = 0; t < nbThreads; t++)
+			threads.emplace_back([&, t]()
+								 { ordonnanceur.travailler(t); });
+		for (std::thread &th : threads)
+			th.join();
+		ResultatFinDePartie r = recherche.evaluer(racine); // 已在记忆表中
+
+		stats.nbEtats = recherche.getNbEtats();
+		stats.nbTaches = ordonnanceur.getNbTaches();
+		stats.nbVols = ordonnanceur.getNbVols();
+		stats.dureeSecondes = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+		return r;
+	}
+
+	ostream &operator<<(ostream &f, const ResultatFinDePartie &r)
+	{
+		f << "sets esperes (jeu optimal) : " << r.esperanceSets << "\n";
+		f << "P(vider le jeu)            : " << r.probaVider << "\n";
+		f << "sets au mieux              : " << r.maxSets << "\n";
+		return f;
+	}
+
+} // end of namespace Set
@@ -0,0 +1,98 @@
+#ifndef _SOLVEUR_H
+#define _SOLVEUR_H
+
+#include "set.h"
+#include <cstdint>
+
+/**
+ * ============================================================================
+ * 残局求解器 (Parallel Exhaustive Endgame Solver)
+ * ============================================================================
+ *
+ * 问题：牌堆只剩不超过 15 张时，穷举所有选择，回答
+ * - 最好情况下还能拿到多少个 SET（所有选择和所有发牌结果中的最大值）
+ * - 最优策略下期望还能拿到多少个 SET
+ * - 最优策略下把牌全部拿完（桌面和牌堆都为空）的概率
+ *
+ * 对局规则与 Controleur 相同：
+ * - 桌面上有 SET 时，玩家选一个拿走，然后 distribuer()（先补一张，再补到 12 张）
+ * - 没有 SET 时，牌堆不空就 distribuer()，牌堆为空则对局结束
+ * - 发牌是随机的：从牌堆的 d 张牌中抽 k 张，C(d, k) 种结果等概率
+ *
+ * 搜索方法（expectimax）：
+ * - 决策节点：对桌面上的每个 SET 取最大值
+ * - 机会节点：对所有发牌结果取平均（最好情况取最大）
+ *
+ * 剪枝与复用：
+ * - 记忆化：状态 = (桌面掩码, 牌堆掩码)，不同的出牌顺序到达同一局面时直接复用（分片哈希表，多线程共享）
+ * - 发牌结果按"组合"枚举，而不是排列（抽到 {a,b,c} 与抽到 {c,a,b} 是同一个局面），这只是正确的计数
+ * - 不做对称性剪枝：残局的稳定子（保持桌面和牌堆不变的对称变换）几乎总是平凡的，
+ *   随机对局中只有约 5% 的残局有非平凡稳定子，而求稳定子或规范形（symetrie.h）的代价远高于一次记忆表查询
+ * - 上界：剩余卡牌全部拿完（期望 = 剩余张数 / 3 且概率为 1）时，其它选择不可能更好，直接停止
+ *
+ * 并行：
+ * - 牌堆比根节点少不超过 3 张的局面拆成任务：它的每个"选择 SET + 发牌结果"子局面压入当前线程的任务队列，
+ *   更小的局面在一个任务内串行求解
+ * - 每个线程有自己的任务队列，自己的做完后去别的线程队列的另一端"偷"任务（work stealing），深层的子树也能分给多个线程
+ * - 子任务全部完成后，由最后完成的线程汇总父局面并逐层向上通知，线程从不阻塞等待子任务
+ * - 所有线程共享同一个记忆表；局面先登记为"计算中"，其它线程遇到时等待结果，同一棵子树不会被算两次
+ */
+namespace Set
+{
+	/**
+	 * ResultatFinDePartie: 从某个局面开始的求解结果
+	 */
+	struct ResultatFinDePartie
+	{
+		double esperanceSets = 0; // 最优策略下期望还能拿到的 SET 数
+		double probaVider = 0;	  // 最优策略下拿完所有卡牌的概率
+		unsigned maxSets = 0;	  // 最好情况下能拿到的 SET 数
+	};
+
+	/**
+	 * StatistiquesSolveur: 求解过程的统计信息
+	 */
+	struct StatistiquesSolveur
+	{
+		size_t nbEtats = 0;	 // 记忆表中的局面数
+		size_t nbTaches = 0; // 拆分出的任务数
+		size_t nbVols = 0;	 // 被其它线程偷走的任务数
+		double dureeSecondes = 0;
+	};
+
+	/**
+	 * SolveurFinDePartie: 残局求解器
+	 *
+	 * 使用示例：
+	 *   EtatJeu e = controleur.sauvegarder();
+	 *   SolveurFinDePartie solveur(e.plateau, e.getMasquePioche());
+	 *   ResultatFinDePartie r = solveur.resoudre();
+	 */
+	class SolveurFinDePartie
+	{
+	private:
+		MasqueCartes plateau;
+		MasqueCartes pioche;
+		unsigned nbThreads;
+		StatistiquesSolveur stats;
+
+	public:
+		static constexpr size_t MAX_PIOCHE = 15;
+
+		/**
+		 * 构造函数
+		 * - nbThreads == 0 表示使用所有核心
+		 * 异常：牌堆超过 MAX_PIOCHE 张，或桌面与牌堆有重复卡牌时抛出 SetException
+		 */
+		SolveurFinDePartie(const MasqueCartes &plateau, const MasqueCartes &pioche, unsigned nbThreads = 0);
+
+		ResultatFinDePartie resoudre();
+
+		const StatistiquesSolveur &getStatistiques() const { return stats; }
+	};
+
+	ostream &operator<<(ostream &f, const ResultatFinDePartie &r);
+
+} // end of namespace Set
+
+#endif // _SOLVEUR_H
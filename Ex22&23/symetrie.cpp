@@ -0,0 +1,202 @@
+/**
+ * ============================================================================
+ * 桌面规范形式实现文件 (Board Canonicalisation Implementation)
+ * ============================================================================
+ */
+
+#include "symetrie.h"
+#include <algorithm>
+
+namespace Set
+{
+	namespace
+	{
+		/**
+		 * avant: 掩码 a 的像是否比 b 的像"小"（按排序后的编号比较字典序）
+		 * 两者卡牌数相同时，不同的最低位在 a 中 ⇔ a 更小
+		 */
+		bool avant(const MasqueCartes &a, const MasqueCartes &b)
+		{
+			for (size_t m = 0; m < 2; m++)
+			{
+				std::uint64_t x = a.mots[m] ^ b.mots[m];
+				if (x)
+					return a.mots[m] & (x & -x);
+			}
+			return false;
+		}
+
+		/**
+		 * genererDistances: DISTANCES[a][b] = 两张卡不同的特征个数（0..4），编译期生成
+		 */
+		constexpr std::array<std::array<std::uint8_t, config::NB_CARTES>, config::NB_CARTES> genererDistances()
+		{
+			std::array<std::array<std::uint8_t, config::NB_CARTES>, config::NB_CARTES> t{};
+			for (size_t a = 0; a < config::NB_CARTES; a++)
+				for (size_t b = 0; b < config::NB_CARTES; b++)
+					for (size_t k = 0; k < config::NB_ATTRIBUTS; k++)
+						t[a][b] += chiffre(CarteId(a), k) != chiffre(CarteId(b), k);
+			return t;
+		}
+		constexpr auto DISTANCES = genererDistances();
+
+		/**
+		 * invariant: 在所有变换下不变的一张卡的特征值
+		 * - 经过它的 SET 数（在 m 中）
+		 * - 到 m 中、到 autre 中的卡分别有几张相差 1、2、3、4 个特征
+		 *   （交换特征和置换取值都不改变"相差几个特征"）
+		 * 打包成一个整数：SET 数在最高位，其余每项 7 位
+		 */
+		std::uint64_t invariant(const MasqueCartes &m, const MasqueCartes &autre, CarteId x)
+		{
+			std::uint64_t profil[2][config::NB_ATTRIBUTS + 1] = {};
+			m.pourChaque([&](CarteId y)
+						 { profil[0][DISTANCES[x][y]]++; });
+			autre.pourChaque([&](CarteId y)
+							 { profil[1][DISTANCES[x][y]]++; });
+			std::uint64_t v = compterSetsAvec(m, x);
+			for (size_t i = 0; i < 2; i++)
+				for (size_t d = 1; d <= config::NB_ATTRIBUTS; d++)
+					v = (v << 7) | profil[i][d];
+			return v;
+		}
+
+		/**
+		 * choisirAncres: m 中 invariant 最大的卡，写入 ancres，返回个数
+		 */
+		size_t choisirAncres(const MasqueCartes &m, const MasqueCartes &autre, CarteId *ancres)
+		{
+			size_t n = 0;
+			std::uint64_t meilleur = 0;
+			m.pourChaque([&](CarteId id)
+						 {
+				std::uint64_t v = invariant(m, autre, id);
+				if (n == 0 || v > meilleur)
+				{
+					meilleur = v;
+					n = 0;
+				}
+				if (v == meilleur)
+					ancres[n++] = id; });
+			return n;
+		}
+
+		/**
+		 * traduire: 把 m 中的卡写成 c - x（c 的对面为 oppose），返回张数
+		 */
+		size_t traduire(const MasqueCartes &m, CarteId oppose, CarteId *sortie)
+		{
+			size_t n = 0;
+			m.pourChaque([&](CarteId id)
+						 { sortie[n++] = troisieme(id, oppose); });
+			return n;
+		}
+
+		MasqueCartes image(const std::array<CarteId, config::NB_CARTES> &l, const CarteId *ids, size_t n)
+		{
+			MasqueCartes m;
+			for (size_t i = 0; i < n; i++)
+				m.ajouter(l[ids[i]]);
+			return m;
+		}
+	}
+
+	std::uint16_t Symetrie::indiceInverse(std::uint16_t i)
+	{
+		static const std::array<std::uint16_t, NB_SYMETRIES_LINEAIRES> inverses = []()
+		{
+			std::array<std::uint16_t, NB_SYMETRIES_LINEAIRES> t{};
+			for (size_t a = 0; a < NB_SYMETRIES_LINEAIRES; a++)
+				for (size_t b = 0; b < NB_SYMETRIES_LINEAIRES; b++)
+				{
+					// 线性变换由 4 个基向量（编号 1、3、9、27）的像决定
+					bool ok = true;
+					for (CarteId e : {1, 3, 9, 27})
+						ok = ok && SYMETRIES_LINEAIRES[b][SYMETRIES_LINEAIRES[a][e]] == e;
+					if (ok)
+					{
+						t[a] = std::uint16_t(b);
+						break;
+					}
+				}
+			return t;
+		}();
+		return inverses[i];
+	}
+
+	MasqueCartes Symetrie::appliquer(const MasqueCartes &m) const
+	{
+		MasqueCartes r;
+		m.pourChaque([&](CarteId id)
+					 { r.ajouter(appliquer(id)); });
+		return r;
+	}
+
+	Triplet Symetrie::appliquer(const Triplet &t) const
+	{
+		CarteId x[3] = {appliquer(t.a), appliquer(t.b), appliquer(t.c)};
+		std::sort(x, x + 3);
+		return Triplet{x[0], x[1], x[2]};
+	}
+
+	FormeCanonique canonique(const MasqueCartes &plateau)
+	{
+		return canonique(plateau, MasqueCartes());
+	}
+
+	FormeCanonique canonique(const MasqueCartes &plateau, const MasqueCartes &pioche)
+	{
+		FormeCanonique f{plateau, pioche, Symetrie()};
+		const MasqueCartes &base = plateau.estVide() ? pioche : plateau;
+		if (base.estVide())
+			return f;
+
+		CarteId ancres[config::NB_CARTES];
+		size_t nbAncres = choisirAncres(base, plateau.estVide() ? plateau : pioche, ancres);
+		CarteId cartesPlateau[config::NB_CARTES], cartesPioche[config::NB_CARTES];
+		bool premier = true;
+		for (size_t a = 0; a < nbAncres; a++)
+		{
+			CarteId oppose = troisieme(ancres[a], 0);
+			size_t nbPlateau = traduire(plateau, oppose, cartesPlateau);
+			size_t nbPioche = traduire(pioche, oppose, cartesPioche);
+			for (std::uint16_t l = 0; l < NB_SYMETRIES_LINEAIRES; l++)
+			{
+				const std::array<CarteId, config::NB_CARTES> &table = SYMETRIES_LINEAIRES[l];
+				MasqueCartes p = image(table, cartesPlateau, nbPlateau);
+				if (!premier && avant(f.plateau, p))
+					continue;
+				// 桌面的像相同时才需要比较牌堆的像
+				MasqueCartes q = image(table, cartesPioche, nbPioche);
+				if (premier || p != f.plateau || avant(q, f.pioche))
+				{
+					f.plateau = p;
+					f.pioche = q;
+					f.symetrie = Symetrie(l, ancres[a]);
+					premier = false;
+				}
+			}
+		}
+		return f;
+	}
+
+	std::vector<Triplet> trouverSetsCanonique(const MasqueCartes &plateau, CacheCanonique<std::vector<Triplet>> &cache)
+	{
+		FormeCanonique f = canonique(plateau);
+		const std::vector<Triplet> &sets = cache.obtenir(f, [&]()
+														 {
+			CarteId ids[config::NB_CARTES];
+			size_t n = 0;
+			f.plateau.pourChaque([&](CarteId id)
+								 { ids[n++] = id; });
+			return trouverSets(ids, n); });
+
+		Symetrie inverse = f.symetrie.inverse();
+		std::vector<Triplet> resultat;
+		resultat.reserve(sets.size());
+		for (const Triplet &t : sets)
+			resultat.push_back(inverse.appliquer(t));
+		return resultat;
+	}
+
+} // end of namespace Set
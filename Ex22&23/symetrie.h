@@ -0,0 +1,219 @@
+#ifndef _SYMETRIE_H
+#define _SYMETRIE_H
+
+#include "set.h"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * ============================================================================
+ * 桌面的规范形式 (Board Canonicalisation under Affine Symmetries)
+ * ============================================================================
+ *
+ * 把卡牌看作 F₃⁴ 中的点（编号的 4 位三进制数字），下列变换不改变"哪三张卡构成 SET"：
+ * - 交换特征：例如把颜色和形状对调（4! = 24 种）
+ * - 在某个特征内部置换取值：例如把红和绿对调（每个特征 3! = 6 种）
+ * 任意值置换都是仿射映射 x -> a·x + b（a = ±1），所以整个群 = 平移 (81) × 带符号的坐标置换 (24 × 2⁴ = 384)，
+ * 共 31104 个元素。等价的桌面有相同的 SET 个数、相同的残局结果、相同的统计量
+ *
+ * 规范形式：群作用下所有像中"最小"的那个掩码
+ * - 顺序：把卡牌按编号排序后比较字典序（等价于：两掩码不同的最低位在谁那里，谁就更小）
+ * - 最小的像一定包含 0 号卡，所以只需考虑把桌面上某张卡（锚点）平移到 0 的变换：n × 384 个
+ * - 进一步：锚点只在不变量最大的卡中选。不变量 = 经过它的 SET 数 + 与其它卡"相差几个特征"的分布，
+ *   在变换下不变，所以等价桌面选出的锚点也互相对应，规范形式仍然唯一；通常只剩 1~2 个锚点
+ *
+ * 使用示例：
+ *   FormeCanonique f = canonique(plateau.getMasque());
+ *   CacheCanonique<std::vector<Triplet>> cache;
+ *   std::vector<Triplet> sets = trouverSetsCanonique(plateau.getMasque(), cache);
+ */
+namespace Set
+{
+	constexpr size_t NB_SYMETRIES_LINEAIRES = 384;
+
+	/**
+	 * genererSymetriesLineaires: 在编译期生成 384 个带符号坐标置换作用在 81 张卡上的像
+	 * 第 i 个变换：置换 i / 16（字典序第 i / 16 个排列），符号位 i % 16（第 k 位为 1 表示第 k 个坐标取反）
+	 * 像的第 perm[k] 个坐标 = ±(原来的第 k 个坐标)
+	 */
+	constexpr std::array<std::array<CarteId, config::NB_CARTES>, NB_SYMETRIES_LINEAIRES> genererSymetriesLineaires()
+	{
+		std::array<std::array<CarteId, config::NB_CARTES>, NB_SYMETRIES_LINEAIRES> t{};
+		size_t perm[config::NB_ATTRIBUTS] = {0, 1, 2, 3};
+		for (size_t p = 0; p < 24; p++)
+		{
+			for (size_t signes = 0; signes < 16; signes++)
+				for (size_t id = 0; id < config::NB_CARTES; id++)
+				{
+					unsigned x[config::NB_ATTRIBUTS] = {};
+					for (size_t k = 0; k < config::NB_ATTRIBUTS; k++)
+					{
+						unsigned v = chiffre(CarteId(id), k);
+						x[perm[k]] = (signes >> k) & 1 ? (config::NB_VALEURS - v) % config::NB_VALEURS : v;
+					}
+					unsigned image = 0;
+					for (size_t k = 0; k < config::NB_ATTRIBUTS; k++)
+						image = image * config::NB_VALEURS + x[k];
+					t[p * 16 + signes][id] = CarteId(image);
+				}
+			// 下一个排列（字典序）
+			size_t i = config::NB_ATTRIBUTS - 1;
+			while (i > 0 && perm[i - 1] >= perm[i])
+				i--;
+			if (i == 0)
+				break;
+			size_t j = config::NB_ATTRIBUTS - 1;
+			while (perm[j] <= perm[i - 1])
+				j--;
+			size_t tmp = perm[i - 1];
+			perm[i - 1] = perm[j];
+			perm[j] = tmp;
+			for (size_t a = i, b = config::NB_ATTRIBUTS - 1; a < b; a++, b--)
+			{
+				tmp = perm[a];
+				perm[a] = perm[b];
+				perm[b] = tmp;
+			}
+		}
+		return t;
+	}
+
+	/**
+	 * SYMETRIES_LINEAIRES[i][id]: 第 i 个线性变换下 id 的像（384 × 81 = 31104 字节，编译期生成）
+	 */
+	inline constexpr auto SYMETRIES_LINEAIRES = genererSymetriesLineaires();
+
+	/**
+	 * MOINS_IDENTITE: x -> -x 的下标（恒等排列、4 个坐标都取反）
+	 */
+	constexpr std::uint16_t MOINS_IDENTITE = 15;
+
+	/**
+	 * Symetrie: 群中的一个元素，x -> L(c - x)
+	 * - L = SYMETRIES_LINEAIRES[lineaire]，c = ancre
+	 * - c - x = troisieme(x, -c)，-c = troisieme(c, 0)，所以一次变换只需两次查表
+	 * - 包含 -x 是为了少查一次表；-I 本身也在 384 个线性变换里，所以元素集合不变
+	 */
+	class Symetrie
+	{
+	private:
+		std::uint16_t lineaire;
+		CarteId ancre;
+		CarteId oppose; // -ancre
+
+		static std::uint16_t indiceInverse(std::uint16_t i);
+
+	public:
+		/**
+		 * 默认构造：恒等变换（L = -I，c = 0）
+		 */
+		Symetrie() : Symetrie(MOINS_IDENTITE, 0) {}
+		Symetrie(std::uint16_t l, CarteId c) : lineaire(l), ancre(c), oppose(troisieme(c, 0)) {}
+
+		std::uint16_t getLineaire() const { return lineaire; }
+		CarteId getAncre() const { return ancre; }
+
+		CarteId appliquer(CarteId x) const { return SYMETRIES_LINEAIRES[lineaire][troisieme(x, oppose)]; }
+		MasqueCartes appliquer(const MasqueCartes &m) const;
+
+		/**
+		 * appliquer(Triplet): 变换三张卡并重新排序（a < b < c）
+		 */
+		Triplet appliquer(const Triplet &t) const;
+
+		/**
+		 * inverse: y -> c - L⁻¹(y) = L⁻¹(L(c) - y)
+		 */
+		Symetrie inverse() const { return Symetrie(indiceInverse(lineaire), SYMETRIES_LINEAIRES[lineaire][ancre]); }
+	};
+
+	/**
+	 * FormeCanonique: 规范形式，以及把原桌面变成它的变换
+	 * 对原桌面算出的结果可以用 symetrie 变换到规范坐标，反之用 symetrie.inverse()
+	 */
+	struct FormeCanonique
+	{
+		MasqueCartes plateau;
+		MasqueCartes pioche;
+		Symetrie symetrie;
+
+		bool operator==(const FormeCanonique &f) const { return plateau == f.plateau && pioche == f.pioche; }
+	};
+
+	/**
+	 * canonique: 桌面的规范形式
+	 * 等价的桌面（同一个群轨道）得到相同的 plateau；空桌面返回自身
+	 */
+	FormeCanonique canonique(const MasqueCartes &plateau);
+
+	/**
+	 * canonique: (桌面, 牌堆) 状态的规范形式，用于残局求解等需要整个状态的场合
+	 * 先比较桌面的像，相同时再比较牌堆的像；桌面为空时锚点从牌堆中选
+	 */
+	FormeCanonique canonique(const MasqueCartes &plateau, const MasqueCartes &pioche);
+
+	/**
+	 * CacheCanonique: 以规范形式为键的记忆表
+	 * - 等价的状态共用一个条目；值必须在变换下不变（计数、概率），
+	 *   或者按规范坐标存储、取出后用 symetrie.inverse() 变回原坐标（例如 Triplet）
+	 * - 条目数达到 capacite 时整体清空（简单，且不需要记录访问顺序）
+	 * - 不是线程安全的：每个线程使用自己的实例
+	 */
+	template <typename V>
+	class CacheCanonique
+	{
+	private:
+		struct Cle
+		{
+			MasqueCartes plateau, pioche;
+			bool operator==(const Cle &c) const { return plateau == c.plateau && pioche == c.pioche; }
+		};
+		struct HashCle
+		{
+			size_t operator()(const Cle &c) const { return size_t(hashZobrist(c.plateau, c.pioche)); }
+		};
+
+		std::unordered_map<Cle, V, HashCle> table;
+		size_t capacite;
+		size_t nbSucces = 0;
+		size_t nbEchecs = 0;
+
+	public:
+		explicit CacheCanonique(size_t c = size_t(1) << 20) : capacite(c) {}
+
+		/**
+		 * obtenir: 查找规范形式 f；没有时调用 calculer() 计算并插入
+		 */
+		template <typename F>
+		const V &obtenir(const FormeCanonique &f, F calculer)
+		{
+			Cle cle{f.plateau, f.pioche};
+			auto it = table.find(cle);
+			if (it != table.end())
+			{
+				nbSucces++;
+				return it->second;
+			}
+			nbEchecs++;
+			if (table.size() >= capacite)
+				table.clear();
+			return table.emplace(cle, calculer()).first->second;
+		}
+
+		size_t getNbEntrees() const { return table.size(); }
+		size_t getNbSucces() const { return nbSucces; }
+		size_t getNbEchecs() const { return nbEchecs; }
+		double tauxSucces() const { return nbSucces + nbEchecs ? double(nbSucces) / double(nbSucces + nbEchecs) : 0; }
+		void vider() { table.clear(); }
+	};
+
+	/**
+	 * trouverSetsCanonique: 与 trouverSets 相同的结果（顺序可能不同），
+	 * 但等价的桌面只计算一次：缓存中存规范坐标下的 SET，取出后变回原坐标
+	 */
+	std::vector<Triplet> trouverSetsCanonique(const MasqueCartes &plateau, CacheCanonique<std::vector<Triplet>> &cache);
+
+} // end of namespace Set
+
+#endif // _SYMETRIE_H
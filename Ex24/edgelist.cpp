@@ -0,0 +1,185 @@
+#include "edgelist.h"
+#include "mappedfile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    constexpr size_t CHUNK_SIZE = size_t(16) << 20;
+    constexpr size_t MAX_TEXT = 80;
+
+    // 一块的解析结果
+    struct Chunk
+    {
+        const char *first;
+        const char *last;
+        vector<Edge> edges;
+        size_t nbLines = 0;
+        size_t nbComments = 0;
+        size_t nbErrors = 0;
+        vector<ParseError> errors; // line 暂时是块内行号（从 0 开始）
+
+        Chunk(const char *b, const char *e) : first(b), last(e) {}
+    };
+
+    inline bool isBlank(char c) { return c == ' ' || c == '\t'; }
+    inline bool isComment(char c) { return c == '#' || c == '%'; }
+
+    // 跳过空白后，p 处是行尾、'\r' 或注释时返回 true
+    inline bool atEndOfLine(const char *p, const char *eol)
+    {
+        return p == eol || *p == '\r' || isComment(*p);
+    }
+
+    /*
+    parseVertex: 解析一个非负整数并前进 p
+    不经过 strtoul / istream：不查 locale、不需要 '\0' 结尾，每个字符只做一次减法和比较
+    @return nullptr 表示成功，否则是错误原因
+    */
+    inline const char *parseVertex(const char *&p, const char *eol, unsigned int &v)
+    {
+        if (p == eol || unsigned(*p - '0') > 9)
+            return "expected a vertex number";
+        uint64_t x = 0;
+        do
+        {
+            x = x * 10 + unsigned(*p++ - '0');
+            if (x > UINT_MAX)
+                return "vertex number out of range";
+        } while (p != eol && unsigned(*p - '0') <= 9);
+        v = unsigned(x);
+        return nullptr;
+    }
+
+    // 解析一行 [p, eol)，成功时加入 c.edges，否则记一条错误
+    void parseLine(const char *p, const char *eol, Chunk &c, size_t maxErrors)
+    {
+        const char *begin = p;
+        const char *error = nullptr;
+        while (p != eol && isBlank(*p))
+            ++p;
+        if (atEndOfLine(p, eol) && (p == eol || *p != '\r' || p + 1 == eol))
+        {
+            c.nbComments++;
+            return;
+        }
+
+        unsigned int i = 0, j = 0;
+        if (!(error = parseVertex(p, eol, i)))
+        {
+            if (p == eol || !isBlank(*p))
+                error = atEndOfLine(p, eol) ? "missing second vertex" : "unexpected character";
+            else
+            {
+                while (p != eol && isBlank(*p))
+                    ++p;
+                if (!(error = parseVertex(p, eol, j)))
+                {
+                    while (p != eol && isBlank(*p))
+                        ++p;
+                    if (p != eol && !isComment(*p) && !(*p == '\r' && p + 1 == eol))
+                        error = unsigned(*p - '0') <= 9 ? "too many columns" : "unexpected character";
+                }
+                else if (atEndOfLine(p, eol))
+                    error = "missing second vertex";
+            }
+        }
+        if (!error)
+        {
+            c.edges.emplace_back(i, j);
+            return;
+        }
+        if (c.nbErrors++ < maxErrors)
+            c.errors.push_back({c.nbLines, error, string(begin, min<size_t>(size_t(eol - begin), MAX_TEXT))});
+    }
+
+    void parseChunk(Chunk &c, size_t maxErrors)
+    {
+        c.edges.reserve(size_t(c.last - c.first) / 12); // 经验值：典型的边表每行 10~16 字节
+        for (const char *p = c.first; p != c.last;)
+        {
+            const char *eol = static_cast<const char *>(memchr(p, '\n', size_t(c.last - p)));
+            if (!eol)
+                eol = c.last;
+            parseLine(p, eol, c, maxErrors);
+            c.nbLines++;
+            p = eol == c.last ? eol : eol + 1;
+        }
+    }
+}
+
+EdgeListReport readEdgeList(const string &path, GraphBuilder &builder, size_t maxErrors)
+{
+    MappedFile file(path);
+    EdgeListReport r;
+    r.nbBytes = file.size();
+    const char *data = file.data(), *end = data + file.size();
+
+    // 1. 切块：目标边界之后的第一个换行符处断开，保证每行完整地落在一个块中
+    const unsigned int T = builder.getNbThreads();
+    size_t nbChunks = max<size_t>(size_t(4) * T, (file.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    vector<Chunk> chunks;
+    const char *p = data;
+    for (size_t k = 1; k <= nbChunks && p != end; ++k)
+    {
+        const char *q = data + file.size() * k / nbChunks;
+        if (q < p)
+            q = p;
+        if (q != end)
+        {
+            const char *nl = static_cast<const char *>(memchr(q, '\n', size_t(end - q)));
+            q = nl ? nl + 1 : end;
+        }
+        if (q != p)
+            chunks.emplace_back(p, q);
+        p = q;
+    }
+
+    // 2. 并行解析
+    auto start = chrono::steady_clock::now();
+    atomic<size_t> next(0);
+    vector<thread> threads;
+    for (unsigned int t = 0; t < T; ++t)
+        threads.emplace_back([&]()
+                             {
+            for (size_t k; (k = next.fetch_add(1)) < chunks.size();)
+                parseChunk(chunks[k], maxErrors); });
+    for (thread &th : threads)
+        th.join();
+    r.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // 3. 汇总：行号改为全局行号（从 1 开始），每块的边按文件顺序整块移交给 builder（不复制）
+    for (Chunk &c : chunks)
+    {
+        for (ParseError &e : c.errors)
+        {
+            e.line += r.nbLines + 1;
+            if (r.errors.size() < maxErrors)
+                r.errors.push_back(move(e));
+        }
+        r.nbLines += c.nbLines;
+        r.nbComments += c.nbComments;
+        r.nbErrors += c.nbErrors;
+        r.nbEdges += c.edges.size();
+        builder.addEdges(move(c.edges));
+    }
+    return r;
+}
+
+ostream &operator<<(ostream &f, const EdgeListReport &r)
+{
+    f << "bytes    : " << r.nbBytes << "\n";
+    f << "lines    : " << r.nbLines << " (" << r.nbComments << " comments or blank)\n";
+    f << "edges    : " << r.nbEdges << "\n";
+    f << "errors   : " << r.nbErrors << "\n";
+    for (const ParseError &e : r.errors)
+        f << "  line " << e.line << ": " << e.message << ": " << e.text << "\n";
+    if (r.errors.size() < r.nbErrors)
+        f << "  ... (" << r.nbErrors - r.errors.size() << " more)\n";
+    f << "speed    : " << r.megaBytesPerSecond() << " MB/s (" << r.seconds << " s)\n";
+    return f;
+}
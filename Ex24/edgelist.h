@@ -0,0 +1,57 @@
+#ifndef _EDGELIST_H_
+#define _EDGELIST_H_
+
+#include "graphbuilder.h"
+
+/*
+文本边表读取 (Text Edge-list Loader)
+
+文件格式：每行一条边 "i j"（两个非负整数，用空格或制表符分隔）
+- '#' 或 '%' 开始的部分是注释，直到行末（整行注释或行尾注释都可以）
+- 空行、只有空白的行被忽略；行尾的 '\r' 被忽略（Windows 换行）
+- 其它情况（只有一个数、多于两个数、非数字字符、超出 unsigned int 范围）都是格式错误：
+  该行被跳过，记录行号和原因，读取继续
+
+实现：
+- MappedFile 映射整个文件，按换行符把它切成若干块（每块约 16 MB，至少线程数的 4 倍块）
+- 线程轮流领取块，用手写的整数解析（不经过 locale / istream），每块得到自己的边数组
+- 行号：每块先记块内行号，全部完成后按块的行数前缀和改为全局行号
+- 各块的边数组按文件顺序整块移交给 GraphBuilder（不复制，每条边只占一份 8 字节），由调用者决定何时 build
+
+使用示例：
+    GraphBuilder b("web", 0, DuplicatePolicy::merge); // 顶点数由最大编号决定
+    EdgeListReport r = readEdgeList("web.txt", b);
+    cout << r;
+    CsrGraph G = b.buildCsr();
+*/
+
+// 一行格式错误：行号从 1 开始，text 是该行内容（最多 80 个字符）
+struct ParseError
+{
+    size_t line;
+    string message;
+    string text;
+};
+
+struct EdgeListReport
+{
+    size_t nbBytes = 0;
+    size_t nbLines = 0;
+    size_t nbEdges = 0;
+    size_t nbComments = 0; // 注释行和空行
+    size_t nbErrors = 0;
+    vector<ParseError> errors; // 按行号排序，最多 maxErrors 条
+    double seconds = 0;        // 只计解析（映射和切块之后、移交给 GraphBuilder 之前）
+
+    double megaBytesPerSecond() const { return seconds > 0 ? nbBytes / seconds / 1e6 : 0; }
+};
+
+/*
+readEdgeList: 读取 path 中的所有边并加入 builder，使用 builder.getNbThreads() 个线程
+异常：文件无法打开或映射时抛出 GraphException；格式错误不抛异常，记录在返回的报告中
+*/
+EdgeListReport readEdgeList(const string &path, GraphBuilder &builder, size_t maxErrors = 100);
+
+ostream &operator<<(ostream &f, const EdgeListReport &r);
+
+#endif
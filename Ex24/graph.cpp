@@ -17,7 +17,7 @@ void Graph::checkVertex(unsigned int i) const // 通过 size 判断是否越界
     }
 }
 
-Graph::Graph(const string &n, size_t nb) : adj(nb), name(n) {}
+Graph::Graph(const string &n, size_t nb) : adj(nb), radj(nb), name(n) {}
 
 const string &Graph::getName() const
 {
@@ -55,6 +55,10 @@ void Graph::addEdge(unsigned int i, unsigned int j)
     // 保持有序插入（输出更稳定）
     auto pos = lower_bound(lst.begin(), lst.end(), j);
     lst.insert(pos, j);
+
+    // 同步反向邻接，同样有序插入：O(入度)
+    auto &rlst = radj[j];
+    rlst.insert(lower_bound(rlst.begin(), rlst.end(), i), i);
 }
 
 void Graph::removeEdge(unsigned int i, unsigned int j)
@@ -72,6 +76,67 @@ void Graph::removeEdge(unsigned int i, unsigned int j)
         throw GraphException(oss.str());
     }
     lst.erase(it);
+    radj[j].erase(find(radj[j].begin(), radj[j].end(), i)); // 边存在，所以 i 一定在 radj[j] 中
+}
+
+void Graph::addEdges(vector<Edge> edges)
+{
+    for (const Edge &e : edges)
+    {
+        checkVertex(e.first);
+        checkVertex(e.second);
+    }
+
+    auto fail = [](const Edge &e)
+    {
+        ostringstream oss;
+        oss << "GraphException: edge (" << e.first << "," << e.second << ") already exists";
+        throw GraphException(oss.str());
+    };
+
+    // 1. 按 (i, j) 排序，批内重复的边相邻
+    sort(edges.begin(), edges.end());
+    auto dup = adjacent_find(edges.begin(), edges.end());
+    if (dup != edges.end())
+        fail(*dup);
+
+    // 2. 先全部检查再修改：每组与 adj[i] 都有序，同时往前走一遍即可发现重复
+    for (size_t b = 0, e; b < edges.size(); b = e)
+    {
+        unsigned int i = edges[b].first;
+        for (e = b; e < edges.size() && edges[e].first == i; ++e)
+            ;
+        auto it = adj[i].begin();
+        for (size_t k = b; k < e; ++k)
+        {
+            while (it != adj[i].end() && *it < edges[k].second)
+                ++it;
+            if (it != adj[i].end() && *it == edges[k].second)
+                fail(edges[k]);
+        }
+    }
+
+    // 3. 归并：list::merge 只移动节点，不复制
+    for (size_t b = 0, e; b < edges.size(); b = e)
+    {
+        unsigned int i = edges[b].first;
+        list<unsigned int> tmp;
+        for (e = b; e < edges.size() && edges[e].first == i; ++e)
+            tmp.push_back(edges[e].second);
+        adj[i].merge(tmp);
+    }
+
+    // 4. 反向邻接同理，按 (j, i) 排序后分组归并
+    sort(edges.begin(), edges.end(), [](const Edge &x, const Edge &y)
+         { return x.second != y.second ? x.second < y.second : x.first < y.first; });
+    for (size_t b = 0, e; b < edges.size(); b = e)
+    {
+        unsigned int j = edges[b].second;
+        list<unsigned int> tmp;
+        for (e = b; e < edges.size() && edges[e].second == j; ++e)
+            tmp.push_back(edges[e].first);
+        radj[j].merge(tmp);
+    }
 }
 
 const list<unsigned int> &Graph::getSuccessors(unsigned int i) const
@@ -80,36 +145,160 @@ const list<unsigned int> &Graph::getSuccessors(unsigned int i) const
     return adj[i];
 }
 
-const list<unsigned int> Graph::getPredecessors(unsigned int i) const
+const list<unsigned int> &Graph::getPredecessors(unsigned int i) const
 {
     checkVertex(i);
+    return radj[i];
+}
 
-    list<unsigned int> pred;
-    for (unsigned int u = 0; u < adj.size(); ++u)
-    {
-        const auto &lst = adj[u];
-        if (find(lst.begin(), lst.end(), i) != lst.end())
-        {
-            pred.push_back(u);
-        }
-    }
-    // u 是递增扫描，因此 pred 天然有序
-    return pred;
+CsrGraph Graph::freeze() const
+{
+    return CsrGraph(*this);
 }
 
-ostream &operator<<(ostream &f, const Graph &G)
+// 两种表示的输出格式相同，只是 getSuccessors 的返回类型不同，所以用模板共享
+template <class G>
+static ostream &printGraph(ostream &f, const G &g)
 {
-    f << "graph " << G.getName()
-      << " (" << G.getNbVertices() << " vertices and "
-      << G.getNbEdges() << " edges)\n";
+    f << "graph " << g.getName()
+      << " (" << g.getNbVertices() << " vertices and "
+      << g.getNbEdges() << " edges)\n";
 
-    for (unsigned int i = 0; i < G.getNbVertices(); ++i)
+    for (unsigned int i = 0; i < g.getNbVertices(); ++i)
     {
         f << i << ":";
-        const auto &s = G.getSuccessors(i);
+        const auto &s = g.getSuccessors(i);
         for (auto v : s)
             f << " " << v;
         f << "\n";
     }
     return f;
-}
\ No newline at end of file
+}
+
+ostream &operator<<(ostream &f, const Graph &G)
+{
+    return printGraph(f, G);
+}
+
+// ============================================================================
+// CsrGraph
+// ============================================================================
+
+void CsrGraph::checkVertex(unsigned int i) const
+{
+    if (i >= getNbVertices())
+    {
+        ostringstream oss;
+        oss << "GraphException: invalid vertex " << i;
+        throw GraphException(oss.str());
+    }
+}
+
+CsrGraph::CsrGraph(const Graph &G) : name(G.getName())
+{
+    // 先数出每个顶点的出度得到 offsets（前缀和），再一次性分配 targets，避免反复扩容
+    auto a = make_shared<Arrays>();
+    size_t n = G.getNbVertices();
+    a->offsets.resize(n + 1);
+    a->offsets[0] = 0;
+    for (unsigned int i = 0; i < n; ++i)
+        a->offsets[i + 1] = a->offsets[i] + G.getSuccessors(i).size();
+
+    a->targets.resize(a->offsets[n]);
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        const auto &lst = G.getSuccessors(i);
+        copy(lst.begin(), lst.end(), a->targets.begin() + a->offsets[i]); // list 本身有序，所以每段也有序
+    }
+    adopt(a);
+}
+
+CsrGraph::CsrGraph(const string &n, vector<uint64_t> &&off, vector<unsigned int> &&tgt) : name(n)
+{
+    auto a = make_shared<Arrays>();
+    a->offsets = move(off);
+    a->targets = move(tgt);
+    adopt(a);
+}
+
+CsrGraph::CsrGraph(const string &n, size_t nbV, size_t nbE, const uint64_t *off, const unsigned int *tgt,
+                   const uint64_t *predOff, const unsigned int *src, shared_ptr<const void> owner)
+    : name(n), nbVertices(nbV), nbEdges(nbE), offsets(off), targets(tgt), predOffsets(predOff), sources(src),
+      storage(move(owner)) {}
+
+void CsrGraph::adopt(shared_ptr<Arrays> a)
+{
+    size_t n = a->offsets.size() - 1;
+
+    // 反向图：计数排序。先数入度得到 predOffsets，再按起点递增把每条边放进终点的段中，
+    // 所以每段前驱天然有序
+    a->predOffsets.assign(n + 1, 0);
+    for (unsigned int v : a->targets)
+        a->predOffsets[v + 1]++;
+    for (size_t v = 0; v < n; ++v)
+        a->predOffsets[v + 1] += a->predOffsets[v];
+
+    a->sources.resize(a->targets.size());
+    vector<uint64_t> next(a->predOffsets.begin(), a->predOffsets.end() - 1);
+    for (unsigned int i = 0; i < n; ++i)
+        for (uint64_t e = a->offsets[i]; e < a->offsets[i + 1]; ++e)
+            a->sources[next[a->targets[e]]++] = i;
+
+    nbVertices = n;
+    nbEdges = a->targets.size();
+    offsets = a->offsets.data();
+    targets = a->targets.data();
+    predOffsets = a->predOffsets.data();
+    sources = a->sources.data();
+    storage = move(a);
+}
+
+pair<uint64_t, uint64_t> CsrGraph::range(const uint64_t *off, unsigned int i) const
+{
+    checkVertex(i);
+    uint64_t b = off[i], e = off[i + 1];
+    if (b > e || e > nbEdges)
+    {
+        ostringstream oss;
+        oss << "GraphException: corrupted adjacency of vertex " << i << " in " << name;
+        throw GraphException(oss.str());
+    }
+    return make_pair(b, e);
+}
+
+VertexSpan CsrGraph::getSuccessors(unsigned int i) const
+{
+    auto [b, e] = range(offsets, i);
+    return VertexSpan(targets + b, targets + e);
+}
+
+size_t CsrGraph::getOutDegree(unsigned int i) const
+{
+    auto [b, e] = range(offsets, i);
+    return size_t(e - b);
+}
+
+VertexSpan CsrGraph::getPredecessors(unsigned int i) const
+{
+    auto [b, e] = range(predOffsets, i);
+    return VertexSpan(sources + b, sources + e);
+}
+
+size_t CsrGraph::getInDegree(unsigned int i) const
+{
+    auto [b, e] = range(predOffsets, i);
+    return size_t(e - b);
+}
+
+bool CsrGraph::hasEdge(unsigned int i, unsigned int j) const
+{
+    checkVertex(i);
+    checkVertex(j);
+    VertexSpan s = getSuccessors(i);
+    return binary_search(s.begin(), s.end(), j);
+}
+
+ostream &operator<<(ostream &f, const CsrGraph &G)
+{
+    return printGraph(f, G);
+}
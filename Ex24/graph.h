@@ -6,6 +6,9 @@
 #include <list>
 #include <vector>
 #include <iostream>
+#include <cstdint>
+#include <utility>
+#include <memory>
 
 using namespace std;
 
@@ -31,6 +34,12 @@ public:
     const char *what() const noexcept { return info.c_str(); }
 };
 
+class CsrGraph;
+class GraphBuilder;
+
+// 一条有向边 (i, j)：i -> j
+using Edge = pair<unsigned int, unsigned int>;
+
 class Graph
 {
     vector<list<unsigned int>> adj; // adjacency 邻接
@@ -49,10 +58,13 @@ class Graph
     insert(it, x) 在it前插入
     size() 元素个数
     */
+    vector<list<unsigned int>> radj; // 反向邻接：radj[j] 是所有 i -> j 的 i（有序），由 addEdge/removeEdge 同步维护
     string name;
 
     void checkVertex(unsigned int i) const;
 
+    friend class GraphBuilder; // GraphBuilder::build() 直接填充 adj / radj
+
 public:
     Graph(const string &n, size_t nb);
 
@@ -63,10 +75,123 @@ public:
     void addEdge(unsigned int i, unsigned int j);
     void removeEdge(unsigned int i, unsigned int j);
 
+    /*
+    addEdges: 批量加边
+    逐条 addEdge 每次都要在链表上线性查找，起点出度为 d 时加 d 条边是 O(d²)
+    这里先把整批边排序，再按起点分组，每组与已有的有序链表做一次归并：O(m log m + 涉及的链表长度)
+    异常：任何一条边越界或已存在（包括批内重复）时抛出 GraphException，此时图不会被修改
+    */
+    void addEdges(vector<Edge> edges);
+    template <class InputIt>
+    void addEdges(InputIt first, InputIt last) { addEdges(vector<Edge>(first, last)); }
+
     const list<unsigned int> &getSuccessors(unsigned int i) const;
-    const list<unsigned int> getPredecessors(unsigned int i) const;
+    // 原先每次扫描全部邻接表（O(V + E)）并返回一个新建的 list，现在直接返回 radj[i] 的引用：O(1)，不分配
+    const list<unsigned int> &getPredecessors(unsigned int i) const;
+
+    // 冻结：生成只读的 CSR 表示（见下方 CsrGraph），原图不受影响，之后仍可修改
+    CsrGraph freeze() const;
 };
 
 ostream &operator<<(ostream &f, const Graph &G);
 
+/*
+VertexSpan: 一段连续的顶点编号 [first, last)，不拥有内存（类似 C++20 的 std::span<const unsigned int>）
+可以直接用于范围 for：for (auto v : G.getSuccessors(i))
+只在产生它的 CsrGraph 存活期间有效
+*/
+class VertexSpan
+{
+    const unsigned int *first;
+    const unsigned int *last;
+
+public:
+    VertexSpan(const unsigned int *b, const unsigned int *e) : first(b), last(e) {}
+
+    const unsigned int *begin() const { return first; }
+    const unsigned int *end() const { return last; }
+    size_t size() const { return size_t(last - first); }
+    bool empty() const { return first == last; }
+    unsigned int operator[](size_t k) const { return first[k]; }
+};
+
+/*
+CsrGraph: 压缩稀疏行（Compressed Sparse Row）表示，只读
+- targets: 所有边的终点按起点顺序首尾相接，每个顶点的后继仍然有序
+- offsets: 顶点 i 的后继是 targets[offsets[i] .. offsets[i + 1])，offsets 共 n + 1 项
+- predOffsets / sources: 同样格式的反向图，顶点 i 的前驱（有序）是 sources[predOffsets[i] .. predOffsets[i + 1])
+对比 vector<list<unsigned int>>：
+- 每条边 4 字节（链表每个节点要两个指针加数据，再加上分配器开销，通常 24~32 字节）
+- 遍历后继是顺序读一段连续内存，没有指针跳转，预取器可以满带宽工作
+- 代价是不能再增删边：需要修改时在 Graph 上改，再重新 freeze()
+*/
+class CsrGraph
+{
+    string name;
+    size_t nbVertices = 0;
+    size_t nbEdges = 0;
+    const uint64_t *offsets = nullptr;
+    const unsigned int *targets = nullptr;
+    const uint64_t *predOffsets = nullptr;
+    const unsigned int *sources = nullptr;
+
+    /*
+    storage: 拥有上面四个数组的对象
+    - 在内存中构造时是 Arrays（四个 vector）
+    - 从快照打开时是映射整个文件的 MappedFile，数组直接指向映射的页面（见 snapshot.h）
+    CsrGraph 只读，所以拷贝时共享同一份 storage，只增加引用计数
+    */
+    shared_ptr<const void> storage;
+
+    struct Arrays
+    {
+        vector<uint64_t> offsets;
+        vector<unsigned int> targets;
+        vector<uint64_t> predOffsets;
+        vector<unsigned int> sources;
+    };
+
+    void checkVertex(unsigned int i) const;
+
+    /*
+    range: 顶点 i 在 off 中的区间 [off[i], off[i + 1])
+    数组可能来自未经 verify 的快照文件，所以每次都检查 off[i] <= off[i + 1] <= nbEdges（两次比较），
+    损坏时抛出 GraphException 而不是越界访问
+    */
+    pair<uint64_t, uint64_t> range(const uint64_t *off, unsigned int i) const;
+
+    // 由 offsets / targets 生成反向图，然后让四个指针指向 a 中的数组
+    void adopt(shared_ptr<Arrays> a);
+
+    // GraphBuilder 直接交出已排好序的两个数组
+    CsrGraph(const string &n, vector<uint64_t> &&off, vector<unsigned int> &&tgt);
+    friend class GraphBuilder;
+
+    // 快照：数组由 owner 拥有，不复制
+    CsrGraph(const string &n, size_t nbV, size_t nbE, const uint64_t *off, const unsigned int *tgt,
+             const uint64_t *predOff, const unsigned int *src, shared_ptr<const void> owner);
+    friend class Snapshot;
+
+public:
+    explicit CsrGraph(const Graph &G);
+
+    const string &getName() const { return name; }
+    size_t getNbVertices() const { return nbVertices; }
+    size_t getNbEdges() const { return nbEdges; }
+
+    VertexSpan getSuccessors(unsigned int i) const;
+    size_t getOutDegree(unsigned int i) const;
+    VertexSpan getPredecessors(unsigned int i) const;
+    size_t getInDegree(unsigned int i) const;
+    bool hasEdge(unsigned int i, unsigned int j) const; // 后继有序，二分查找
+
+    // 直接访问四个数组（例如整体写入文件）：offsets / predOffsets 有 n + 1 项，targets / sources 有 m 项
+    const uint64_t *getOffsets() const { return offsets; }
+    const unsigned int *getTargets() const { return targets; }
+    const uint64_t *getPredOffsets() const { return predOffsets; }
+    const unsigned int *getSources() const { return sources; }
+};
+
+ostream &operator<<(ostream &f, const CsrGraph &G);
+
 #endif
\ No newline at end of file
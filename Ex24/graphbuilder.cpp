@@ -0,0 +1,239 @@
+#include "graphbuilder.h"
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+// 启动 nbThreads 个线程执行 f(t)，t = 0 .. nbThreads - 1，全部结束后返回
+template <class F>
+static void runParallel(unsigned int nbThreads, F f)
+{
+    vector<thread> threads;
+    for (unsigned int t = 0; t < nbThreads; ++t)
+        threads.emplace_back(f, t);
+    for (thread &th : threads)
+        th.join();
+}
+
+/*
+forEachEdge: 把各块按加入顺序拼接，对第 [b, e) 条边依次调用 f(k, edge)，f 返回 false 时停止
+blockFrom[i] 是第 i 块第一条边的全局下标，blockFrom.back() 是总边数
+*/
+template <class F>
+static void forEachEdge(const vector<vector<Edge>> &blocks, const vector<size_t> &blockFrom, size_t b, size_t e, F f)
+{
+    size_t i = size_t(upper_bound(blockFrom.begin(), blockFrom.end(), b) - blockFrom.begin()) - 1;
+    for (size_t k = b; k < e; ++i)
+    {
+        const Edge *p = blocks[i].data() + (k - blockFrom[i]);
+        for (const size_t end = min(e, blockFrom[i + 1]); k < end; ++k, ++p)
+            if (!f(k, *p))
+                return;
+    }
+}
+
+GraphBuilder::GraphBuilder(const string &n, size_t nb, DuplicatePolicy p, unsigned int t)
+    : name(n), nbVertices(nb), policy(p), nbThreads(t ? t : max(1u, thread::hardware_concurrency())), autoSize(nb == 0) {}
+
+void GraphBuilder::reserve(size_t m)
+{
+    size_t n = getNbPendingEdges();
+    if (m > n)
+        lastBlock().reserve(lastBlock().size() + (m - n));
+}
+
+void GraphBuilder::addEdges(vector<Edge> &&block)
+{
+    if (!block.empty())
+        blocks.push_back(move(block));
+    block.clear();
+}
+
+size_t GraphBuilder::getNbPendingEdges() const
+{
+    size_t m = 0;
+    for (const vector<Edge> &b : blocks)
+        m += b.size();
+    return m;
+}
+
+CsrGraph GraphBuilder::buildCsr()
+{
+    vector<size_t> blockFrom(1, 0);
+    for (const vector<Edge> &b : blocks)
+        blockFrom.push_back(blockFrom.back() + b.size());
+    const size_t m = blockFrom.back();
+    const unsigned int T = nbThreads;
+    auto edgeBlock = [&](unsigned int t)
+    { return make_pair(m * t / T, m * (t + 1) / T); };
+    auto edgeRange = [&](size_t b, size_t e, auto f)
+    { forEachEdge(blocks, blockFrom, b, e, f); };
+
+    // 0. 顶点数未给出时先求最大编号
+    if (autoSize)
+    {
+        vector<size_t> maxId(T, 0);
+        runParallel(T, [&](unsigned int t)
+                    {
+            auto [b, e] = edgeBlock(t);
+            unsigned int mx = 0;
+            edgeRange(b, e, [&](size_t, const Edge &ed)
+                      { mx = max(mx, max(ed.first, ed.second)); return true; });
+            maxId[t] = e > b ? size_t(mx) + 1 : 0; });
+        nbVertices = *max_element(maxId.begin(), maxId.end());
+    }
+    const size_t n = nbVertices;
+
+    // 顶点分成 B 个连续的桶，每桶至多 2^16 个顶点：桶内的计数数组放得进缓存
+    const size_t B = max<size_t>(1, min(n, max<size_t>(4 * T, (n + 65535) / 65536)));
+    const size_t blockSize = n ? (n + B - 1) / B : 1;
+
+    // 1. 每个线程统计自己那段边落在各桶的数量，同时找出越界的边
+    //    （记录下标最小的那条，保证报错信息与线程数无关）
+    vector<vector<uint64_t>> hist(T, vector<uint64_t>(B + 1, 0));
+    atomic<size_t> firstInvalid(m);
+    runParallel(T, [&](unsigned int t)
+                {
+        auto [b, e] = edgeBlock(t);
+        vector<uint64_t> &h = hist[t];
+        edgeRange(b, e, [&](size_t k, const Edge &ed)
+                  {
+            if (ed.first >= n || ed.second >= n)
+            {
+                size_t cur = firstInvalid.load(memory_order_relaxed);
+                while (k < cur && !firstInvalid.compare_exchange_weak(cur, k, memory_order_relaxed))
+                    ;
+                return false;
+            }
+            h[ed.first / blockSize]++;
+            return true; }); });
+    if (firstInvalid < m)
+    {
+        Edge ed(0, 0);
+        edgeRange(firstInvalid, firstInvalid + 1, [&](size_t, const Edge &x)
+                  { ed = x; return true; });
+        ostringstream oss;
+        oss << "GraphException: invalid vertex " << (ed.first >= n ? ed.first : ed.second);
+        throw GraphException(oss.str());
+    }
+
+    // 前缀和（桶优先，同一桶内按线程顺序）：hist[t][b] 变为线程 t 写入桶 b 的起始位置
+    vector<uint64_t> bucketFrom(B + 1);
+    uint64_t pos = 0;
+    for (size_t b = 0; b < B; ++b)
+    {
+        bucketFrom[b] = pos;
+        for (unsigned int t = 0; t < T; ++t)
+        {
+            uint64_t c = hist[t][b];
+            hist[t][b] = pos;
+            pos += c;
+        }
+    }
+    bucketFrom[B] = pos;
+
+    // 2. 按桶分散：每个线程同时只往 B 个位置顺序写，不需要原子操作
+    //    分散后的数组代替原来的各块：出错时已收集的边仍然都在（只是顺序变了）
+    {
+        vector<Edge> bucketed(m);
+        runParallel(T, [&](unsigned int t)
+                    {
+            auto [b, e] = edgeBlock(t);
+            vector<uint64_t> &h = hist[t];
+            edgeRange(b, e, [&](size_t, const Edge &ed)
+                      { bucketed[h[ed.first / blockSize]++] = ed; return true; }); });
+        blocks.clear();
+        blocks.push_back(move(bucketed));
+    }
+    const vector<Edge> &edges = blocks.front();
+
+    // 3. 各桶互不相交，由线程轮流领取：桶内计数 → 前缀和 → 放置终点 → 每段排序 / 去重
+    //    kept[i]：merge 时去重后的出度
+    vector<uint64_t> offsets(n + 1);
+    vector<unsigned int> targets(m);
+    vector<uint64_t> kept(policy == DuplicatePolicy::merge ? n : 0);
+    atomic<size_t> nextBucket(0);
+    atomic<size_t> firstDuplicate(n); // 起点编号最小的重复
+    runParallel(T, [&](unsigned int)
+                {
+        vector<uint64_t> cursor(blockSize);
+        for (size_t b; (b = nextBucket.fetch_add(1)) < B;)
+        {
+            size_t v0 = min(n, b * blockSize), v1 = min(n, v0 + blockSize);
+            fill(cursor.begin(), cursor.end(), 0);
+            for (uint64_t k = bucketFrom[b]; k < bucketFrom[b + 1]; ++k)
+                cursor[edges[k].first - v0]++;
+            uint64_t p = bucketFrom[b];
+            for (size_t v = v0; v < v1; ++v)
+            {
+                offsets[v] = p;
+                uint64_t c = cursor[v - v0];
+                cursor[v - v0] = p;
+                p += c;
+            }
+            for (uint64_t k = bucketFrom[b]; k < bucketFrom[b + 1]; ++k)
+                targets[cursor[edges[k].first - v0]++] = edges[k].second;
+
+            for (size_t i = v0; i < v1; ++i)
+            {
+                unsigned int *s = targets.data() + offsets[i], *e = targets.data() + cursor[i - v0];
+                sort(s, e);
+                if (policy == DuplicatePolicy::merge)
+                    kept[i] = uint64_t(unique(s, e) - s);
+                else if (adjacent_find(s, e) != e)
+                {
+                    size_t cur = firstDuplicate.load(memory_order_relaxed);
+                    while (i < cur && !firstDuplicate.compare_exchange_weak(cur, i, memory_order_relaxed))
+                        ;
+                    break;
+                }
+            }
+        } });
+    offsets[n] = m;
+    if (firstDuplicate < n)
+    {
+        size_t i = firstDuplicate;
+        auto b = targets.begin() + offsets[i], e = targets.begin() + offsets[i + 1];
+        ostringstream oss;
+        oss << "GraphException: edge (" << i << "," << *adjacent_find(b, e) << ") already exists";
+        throw GraphException(oss.str());
+    }
+
+    // 4. merge 且确实删掉了边时，按新的出度压缩到一个新数组
+    if (policy == DuplicatePolicy::merge)
+    {
+        vector<uint64_t> compact(n + 1);
+        compact[0] = 0;
+        for (size_t i = 0; i < n; ++i)
+            compact[i + 1] = compact[i] + kept[i];
+        if (compact[n] != m)
+        {
+            vector<unsigned int> packed(compact[n]);
+            nextBucket = 0;
+            runParallel(T, [&](unsigned int)
+                        {
+                for (size_t b; (b = nextBucket.fetch_add(1)) < B;)
+                    for (size_t i = min(n, b * blockSize); i < min(n, (b + 1) * blockSize); ++i)
+                        copy(targets.begin() + offsets[i], targets.begin() + offsets[i] + kept[i],
+                             packed.begin() + compact[i]); });
+            offsets.swap(compact);
+            targets.swap(packed);
+        }
+    }
+
+    blocks.clear();
+    return CsrGraph(name, move(offsets), move(targets));
+}
+
+Graph GraphBuilder::build()
+{
+    CsrGraph C = buildCsr();
+    Graph G(C.getName(), C.getNbVertices());
+    for (unsigned int i = 0; i < C.getNbVertices(); ++i)
+    {
+        VertexSpan s = C.getSuccessors(i), p = C.getPredecessors(i);
+        G.adj[i].assign(s.begin(), s.end());
+        G.radj[i].assign(p.begin(), p.end());
+    }
+    return G;
+}
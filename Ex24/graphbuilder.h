@@ -0,0 +1,72 @@
+#ifndef _GRAPHBUILDER_H_
+#define _GRAPHBUILDER_H_
+
+#include "graph.h"
+
+/*
+GraphBuilder: 一次性从大量 (i, j) 边构造图
+- 先把所有边收集到若干块里（addEdge / addEdges 只是追加到最后一块，O(1) 均摊；
+  addEdges(vector&&) 把整块移入，不复制），build 时各块按加入顺序视为一个整体
+- build() / buildCsr() 时多线程完成（基数划分，全程不需要原子计数）：
+  1. 顶点按编号分成若干桶（每桶至多 65536 个顶点），每个线程统计自己那段边落在各桶的数量，同时检查越界
+  2. 每个线程把自己的边分散到各桶中（只有桶数个顺序写入流），这是第一次把边复制到一个连续数组中
+  3. 线程轮流领取桶：桶内计数出度、前缀和得到 offsets、放置终点，再对每一段排序、去重或检查重复
+  随机访问都局限在一个桶内，放得进缓存；整个过程不做任何链表操作
+- 重复边的处理由 DuplicatePolicy 决定：
+  reject: 与 Graph::addEdge 相同，发现重复抛出 GraphException
+  merge:  静默合并为一条（适合本来就可能有重复的边表文件）
+
+使用示例：
+    GraphBuilder b("web", 1000000, DuplicatePolicy::merge);
+    b.addEdges(edges.begin(), edges.end());
+    CsrGraph G = b.buildCsr();
+*/
+enum class DuplicatePolicy
+{
+    reject,
+    merge
+};
+
+class GraphBuilder
+{
+    string name;
+    size_t nbVertices;
+    DuplicatePolicy policy;
+    unsigned int nbThreads;
+    bool autoSize;
+    vector<vector<Edge>> blocks; // 不为空时最后一块接收 addEdge / addEdges(first, last)
+
+    vector<Edge> &lastBlock()
+    {
+        if (blocks.empty())
+            blocks.emplace_back();
+        return blocks.back();
+    }
+
+public:
+    // nb == 0 表示顶点数由 build 时的最大顶点编号 + 1 决定（例如从文件读入、事先不知道顶点数）
+    // nbThreads == 0 表示使用所有核心（std::thread::hardware_concurrency）
+    GraphBuilder(const string &n, size_t nb, DuplicatePolicy p = DuplicatePolicy::reject, unsigned int nbThreads = 0);
+
+    // reserve: 总边数不超过 m 时 addEdge / addEdges(first, last) 不重新分配
+    void reserve(size_t m);
+
+    // 只追加，越界和重复在 build 时统一检查
+    void addEdge(unsigned int i, unsigned int j) { lastBlock().emplace_back(i, j); }
+    template <class InputIt>
+    void addEdges(InputIt first, InputIt last) { lastBlock().insert(lastBlock().end(), first, last); }
+    // 整块移入（例如解析器每个线程产生的一块），从不复制；之后的 addEdge 追加到这一块后面
+    void addEdges(vector<Edge> &&block);
+
+    size_t getNbPendingEdges() const;
+    unsigned int getNbThreads() const { return nbThreads; }
+
+    /*
+    buildCsr / build: 构造图并清空已收集的边
+    异常：顶点越界，或 policy == reject 时有重复边，抛出 GraphException（已收集的边都还在，但顺序可能改变）
+    */
+    CsrGraph buildCsr();
+    Graph build();
+};
+
+#endif
@@ -18,6 +18,10 @@ int main()
         G1.addEdge(3, 0);
 
         cout << G1;
+
+        // 冻结为 CSR：后继是一段连续的数组
+        CsrGraph C1 = G1.freeze();
+        cout << C1;
     }
     catch (exception &e)
     {
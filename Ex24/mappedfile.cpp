@@ -0,0 +1,36 @@
+#include "mappedfile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const string &path, bool sequential)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw GraphException("GraphException: cannot open " + path);
+    struct stat infos;
+    if (::fstat(fd, &infos) != 0)
+    {
+        ::close(fd);
+        throw GraphException("GraphException: cannot stat " + path);
+    }
+    length = size_t(infos.st_size);
+    if (length == 0)
+    {
+        ::close(fd);
+        return;
+    }
+    void *p = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // 关闭文件描述符后映射仍然有效
+    if (p == MAP_FAILED)
+        throw GraphException("GraphException: cannot mmap " + path);
+    ::madvise(p, length, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    first = static_cast<const char *>(p);
+}
+
+MappedFile::~MappedFile()
+{
+    if (first)
+        ::munmap(const_cast<char *>(first), length);
+}
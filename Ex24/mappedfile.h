@@ -0,0 +1,28 @@
+#ifndef _MAPPEDFILE_H_
+#define _MAPPEDFILE_H_
+
+#include "graph.h"
+
+/*
+MappedFile: 用 mmap 只读映射整个文件（RAII：析构时 munmap）
+- MAP_SHARED + PROT_READ：页面直接来自页缓存，不复制；多个进程映射同一文件时共享同一份物理页
+- 空文件不映射，data() 为 nullptr、size() 为 0
+异常：文件无法打开、fstat 或 mmap 失败时抛出 GraphException
+*/
+class MappedFile
+{
+    const char *first = nullptr;
+    size_t length = 0;
+
+public:
+    // sequential: 提示内核顺序读取（MADV_SEQUENTIAL，加大预读）；随机访问时传 false
+    explicit MappedFile(const string &path, bool sequential = true);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const { return first; }
+    size_t size() const { return length; }
+};
+
+#endif
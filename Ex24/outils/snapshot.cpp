@@ -0,0 +1,84 @@
+/*
+============================================================================
+图快照命令行工具 (Graph Snapshot Driver)
+============================================================================
+
+用法：
+  ./snapshot save <edges.txt> <file.csr> [--merge]   解析文本边表（打印解析报告，有格式错误时警告），构造 CsrGraph 并写成快照
+  ./snapshot open <file.csr> [--verify]              打开快照（零拷贝），报告打开耗时和一次完整遍历的耗时
+
+编译运行（在 outils 目录下）：
+  g++ -std=c++17 -O2 -pthread snapshot.cpp ../snapshot.cpp ../edgelist.cpp ../mappedfile.cpp ../graphbuilder.cpp ../graph.cpp -o snapshot
+  ./edgelist generate web.txt 5000000 50000000 && ./snapshot save web.txt web.csr --merge && ./snapshot open web.csr
+*/
+
+#include "../edgelist.h"
+#include "../snapshot.h"
+#include <chrono>
+#include <cstring>
+
+static double secondsSince(chrono::steady_clock::time_point t)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - t).count();
+}
+
+static void save(const char *text, const char *path, DuplicatePolicy policy)
+{
+    auto start = chrono::steady_clock::now();
+    GraphBuilder b(text, 0, policy);
+    EdgeListReport r = readEdgeList(text, b);
+    cout << r;
+    // 格式错误的行被跳过：照常写快照，但给出警告，并把跳过的行数记在 metadata 中
+    string metadata = string("source=") + text;
+    if (r.nbErrors > 0)
+    {
+        cerr << "warning: " << r.nbErrors << " malformed lines skipped, the snapshot misses their edges\n";
+        metadata += " skipped_lines=" + to_string(r.nbErrors);
+    }
+    CsrGraph G = b.buildCsr();
+    cout << "parse + build : " << secondsSince(start) << " s\n";
+
+    start = chrono::steady_clock::now();
+    Snapshot::write(G, path, metadata);
+    cout << "write         : " << secondsSince(start) << " s\n";
+}
+
+static void open(const char *path, bool verify)
+{
+    auto start = chrono::steady_clock::now();
+    Snapshot s(path, verify);
+    CsrGraph G = s.getGraph();
+    cout << "open          : " << secondsSince(start) * 1e3 << " ms" << (verify ? " (verified)" : "") << "\n";
+    cout << s.getInfo();
+
+    // 第一次遍历时页面才被读入（或直接来自页缓存）
+    start = chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (unsigned int i = 0; i < G.getNbVertices(); ++i)
+        for (unsigned int v : G.getSuccessors(i))
+            sum += v;
+    cout << "scan          : " << secondsSince(start) << " s (checksum " << sum << ")\n";
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        if (argc >= 4 && strcmp(argv[1], "save") == 0)
+            save(argv[2], argv[3], argc > 4 && strcmp(argv[4], "--merge") == 0 ? DuplicatePolicy::merge : DuplicatePolicy::reject);
+        else if (argc >= 3 && strcmp(argv[1], "open") == 0)
+            open(argv[2], argc > 3 && strcmp(argv[3], "--verify") == 0);
+        else
+        {
+            cerr << "usage: " << argv[0] << " save <edges.txt> <file.csr> [--merge]\n"
+                 << "       " << argv[0] << " open <file.csr> [--verify]\n";
+            return 1;
+        }
+    }
+    catch (exception &e)
+    {
+        cout << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
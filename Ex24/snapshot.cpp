@@ -0,0 +1,252 @@
+#include "snapshot.h"
+#include "mappedfile.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr char MAGIC[8] = {'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+    constexpr uint32_t ENDIAN_MARK = 0x01020304;
+    constexpr size_t ALIGN = 64;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t nbVertices;
+        uint64_t nbEdges;
+        uint64_t nameLength;
+        uint64_t metadataLength;
+        uint64_t payloadChecksum;
+        uint64_t headerChecksum;
+    };
+    static_assert(sizeof(Header) == ALIGN, "snapshot header must be 64 bytes");
+
+    inline size_t padded(size_t len) { return (len + ALIGN - 1) / ALIGN * ALIGN; }
+
+    // 各段相对文件开头的偏移
+    struct Layout
+    {
+        size_t offsets, targets, predOffsets, sources, name, metadata, fileSize;
+
+        Layout(uint64_t n, uint64_t m, uint64_t nameLength, uint64_t metadataLength)
+        {
+            offsets = sizeof(Header);
+            targets = offsets + padded((n + 1) * sizeof(uint64_t));
+            predOffsets = targets + padded(m * sizeof(unsigned int));
+            sources = predOffsets + padded((n + 1) * sizeof(uint64_t));
+            name = sources + padded(m * sizeof(unsigned int));
+            metadata = name + padded(nameLength);
+            fileSize = metadata + padded(metadataLength);
+        }
+    };
+
+    /*
+    Checksum: 64 位校验和，4 路独立累加（同 xxHash64 的轮函数），每次处理 32 字节
+    4 路互不依赖，CPU 可以并行执行，速度接近内存带宽
+    update() 把每段看作用 0 填充到 64 字节的倍数，所以写入时逐段计算与读取时整体计算结果相同
+    */
+    class Checksum
+    {
+        static constexpr uint64_t P1 = 0x9E3779B185EBCA87ull;
+        static constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4Full;
+        uint64_t lane[4] = {P1 + P2, P2, 0, 0 - P1};
+        uint64_t length = 0;
+
+        static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+        void block(const unsigned char *p)
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                uint64_t w;
+                memcpy(&w, p + 8 * k, 8);
+                lane[k] = rotl(lane[k] + w * P2, 31) * P1;
+            }
+        }
+
+    public:
+        void update(const void *data, size_t len)
+        {
+            const unsigned char *p = static_cast<const unsigned char *>(data);
+            size_t full = len / 32 * 32;
+            for (size_t k = 0; k < full; k += 32)
+                block(p + k);
+            unsigned char tail[ALIGN] = {};
+            memcpy(tail, p + full, len - full);
+            for (size_t k = 0; k < padded(len) - full; k += 32)
+                block(tail + k);
+            length += padded(len);
+        }
+
+        uint64_t digest() const
+        {
+            uint64_t h = rotl(lane[0], 1) + rotl(lane[1], 7) + rotl(lane[2], 12) + rotl(lane[3], 18) + length;
+            h ^= h >> 33;
+            h *= P2;
+            h ^= h >> 29;
+            return h;
+        }
+    };
+
+    uint64_t headerChecksum(const Header &h)
+    {
+        Checksum c;
+        c.update(&h, offsetof(Header, headerChecksum));
+        return c.digest();
+    }
+
+    [[noreturn]] void fail(const string &path, const string &why)
+    {
+        throw GraphException("GraphException: snapshot " + path + ": " + why);
+    }
+
+    // 写完 len 字节（::write 可能只写一部分或被信号打断）
+    bool writeAll(int fd, const void *data, size_t len)
+    {
+        const char *p = static_cast<const char *>(data);
+        while (len > 0)
+        {
+            ssize_t k = ::write(fd, p, len);
+            if (k < 0 && errno == EINTR)
+                continue;
+            if (k <= 0)
+                return false;
+            p += k;
+            len -= size_t(k);
+        }
+        return true;
+    }
+
+    // verify 时检查一个 CSR 方向：offsets 单调，终点不越界
+    bool validCsr(const uint64_t *off, const unsigned int *dst, uint64_t n, uint64_t m)
+    {
+        if (off[0] != 0 || off[n] != m)
+            return false;
+        for (uint64_t i = 0; i < n; ++i)
+            if (off[i] > off[i + 1])
+                return false;
+        for (uint64_t e = 0; e < m; ++e)
+            if (dst[e] >= n)
+                return false;
+        return true;
+    }
+}
+
+Snapshot::Snapshot(const string &path, bool verify) : file(make_shared<MappedFile>(path, false))
+{
+    const char *base = file->data();
+    if (file->size() < sizeof(Header))
+        fail(path, "file too small");
+    Header h;
+    memcpy(&h, base, sizeof h);
+    if (memcmp(h.magic, MAGIC, sizeof MAGIC) != 0)
+        fail(path, "not a graph snapshot");
+    if (h.byteOrder != ENDIAN_MARK)
+        fail(path, "byte order mismatch");
+    if (h.version != VERSION)
+        fail(path, "unsupported version " + to_string(h.version));
+    if (h.headerChecksum != headerChecksum(h))
+        fail(path, "corrupted header");
+    if (h.nbVertices > uint64_t(UINT32_MAX) + 1 || h.nbEdges > (uint64_t(1) << 60) ||
+        h.nameLength > file->size() || h.metadataLength > file->size())
+        fail(path, "corrupted header");
+
+    Layout l(h.nbVertices, h.nbEdges, h.nameLength, h.metadataLength);
+    if (l.fileSize != file->size())
+        fail(path, "size mismatch (truncated file?)");
+
+    offsets = reinterpret_cast<const uint64_t *>(base + l.offsets);
+    targets = reinterpret_cast<const unsigned int *>(base + l.targets);
+    predOffsets = reinterpret_cast<const uint64_t *>(base + l.predOffsets);
+    sources = reinterpret_cast<const unsigned int *>(base + l.sources);
+    if (offsets[0] != 0 || offsets[h.nbVertices] != h.nbEdges || predOffsets[0] != 0 || predOffsets[h.nbVertices] != h.nbEdges)
+        fail(path, "corrupted offsets");
+
+    if (verify)
+    {
+        Checksum c;
+        c.update(base + sizeof(Header), file->size() - sizeof(Header));
+        if (c.digest() != h.payloadChecksum)
+            fail(path, "checksum mismatch");
+        if (!validCsr(offsets, targets, h.nbVertices, h.nbEdges) || !validCsr(predOffsets, sources, h.nbVertices, h.nbEdges))
+            fail(path, "invalid adjacency arrays");
+    }
+
+    info.version = h.version;
+    info.name.assign(base + l.name, h.nameLength);
+    info.metadata.assign(base + l.metadata, h.metadataLength);
+    info.nbVertices = h.nbVertices;
+    info.nbEdges = h.nbEdges;
+    info.fileSize = file->size();
+    info.checksum = h.payloadChecksum;
+}
+
+CsrGraph Snapshot::getGraph() const
+{
+    return CsrGraph(info.name, info.nbVertices, info.nbEdges, offsets, targets, predOffsets, sources, file);
+}
+
+void Snapshot::write(const CsrGraph &G, const string &path, const string &metadata)
+{
+    const uint64_t n = G.getNbVertices(), m = G.getNbEdges();
+    const string &name = G.getName();
+    struct Section
+    {
+        const void *data;
+        size_t length;
+    };
+    const Section sections[] = {
+        {G.getOffsets(), (n + 1) * sizeof(uint64_t)},
+        {G.getTargets(), m * sizeof(unsigned int)},
+        {G.getPredOffsets(), (n + 1) * sizeof(uint64_t)},
+        {G.getSources(), m * sizeof(unsigned int)},
+        {name.data(), name.size()},
+        {metadata.data(), metadata.size()},
+    };
+
+    Header h = {};
+    memcpy(h.magic, MAGIC, sizeof MAGIC);
+    h.version = VERSION;
+    h.byteOrder = ENDIAN_MARK;
+    h.nbVertices = n;
+    h.nbEdges = m;
+    h.nameLength = name.size();
+    h.metadataLength = metadata.size();
+    Checksum c;
+    for (const Section &s : sections)
+        c.update(s.data, s.length);
+    h.payloadChecksum = c.digest();
+    h.headerChecksum = headerChecksum(h);
+
+    // 先写 path.tmp 并 fsync，再 rename 覆盖 path：rename 是原子的，中途崩溃或写入失败时 path 仍是完整的旧快照；
+    // 正在映射旧快照的进程也不受影响（旧文件在它们 munmap 之前一直存在），而原地截断会让它们访问页面时收到 SIGBUS
+    const string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fail(path, "cannot create " + tmp);
+    static const char zeros[ALIGN] = {};
+    bool ok = writeAll(fd, &h, sizeof h);
+    for (const Section &s : sections)
+        ok = ok && writeAll(fd, s.data, s.length) && writeAll(fd, zeros, padded(s.length) - s.length);
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || ::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        ::unlink(tmp.c_str());
+        fail(path, "write failed");
+    }
+}
+
+ostream &operator<<(ostream &f, const SnapshotInfo &i)
+{
+    f << "snapshot v" << i.version << " \"" << i.name << "\": " << i.nbVertices << " vertices, " << i.nbEdges
+      << " edges, " << i.fileSize << " bytes, checksum " << hex << i.checksum << dec << "\n";
+    if (!i.metadata.empty())
+        f << i.metadata << "\n";
+    return f;
+}
@@ -0,0 +1,82 @@
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+#include "graph.h"
+
+/*
+CsrGraph 的二进制快照 (Binary Snapshot, zero-copy load)
+
+目的：文本边表每次启动都要重新解析和构造；快照直接存 CsrGraph 的四个数组，
+打开时用 mmap 映射整个文件，CsrGraph 的指针直接指向映射的页面：不解析、不复制，
+页面在第一次访问时才从页缓存读入，多个进程打开同一个快照时共享同一份物理内存
+
+文件格式（版本 1，小端，所有段的起始位置都按 64 字节对齐，段之间用 0 填充）：
+    偏移   内容
+    0      文件头 64 字节：
+             magic "CSRGRAPH"（8）、version（4）、byteOrder 0x01020304（4）、
+             nbVertices（8）、nbEdges（8）、nameLength（8）、metadataLength（8）、
+             payloadChecksum（8，文件头之后所有字节）、headerChecksum（8，文件头前 56 字节）
+    64     offsets      (n + 1) × uint64
+    ...    targets      m × uint32
+    ...    predOffsets  (n + 1) × uint64
+    ...    sources      m × uint32
+    ...    name         nameLength 字节
+    ...    metadata     metadataLength 字节（任意文本，例如来源文件、生成时间）
+
+打开时总是检查：文件头（magic、版本、字节序、headerChecksum）、文件大小、offsets 首尾
+这些都是 O(1)；verify = true 时再读一遍整个文件检查 payloadChecksum 和数组的结构（单调、顶点不越界）
+不 verify 时，offsets 中间的损坏由 CsrGraph 在每次查询时发现（getSuccessors 等检查区间并抛出 GraphException），
+损坏的终点编号在用它查询时被 checkVertex 拒绝，所以损坏的文件不会导致越界访问
+
+使用示例：
+    Snapshot::write(G, "web.csr", "source=web.txt");
+    Snapshot s("web.csr");
+    CsrGraph G2 = s.getGraph(); // 与 s 共享映射，s 析构后 G2 仍然有效
+*/
+
+struct SnapshotInfo
+{
+    uint32_t version = 0;
+    string name;
+    string metadata;
+    size_t nbVertices = 0;
+    size_t nbEdges = 0;
+    size_t fileSize = 0;
+    uint64_t checksum = 0;
+};
+
+class MappedFile;
+
+class Snapshot
+{
+    shared_ptr<const MappedFile> file;
+    SnapshotInfo info;
+    const uint64_t *offsets = nullptr;
+    const unsigned int *targets = nullptr;
+    const uint64_t *predOffsets = nullptr;
+    const unsigned int *sources = nullptr;
+
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    /*
+    打开快照
+    异常：文件无法映射、格式或版本不对、校验失败时抛出 GraphException
+    */
+    explicit Snapshot(const string &path, bool verify = false);
+
+    const SnapshotInfo &getInfo() const { return info; }
+
+    // getGraph: 零拷贝：返回的 CsrGraph 直接引用映射的页面，并持有映射
+    CsrGraph getGraph() const;
+
+    /*
+    write: 把 G 写成快照：先写 path + ".tmp"，fsync 后 rename 覆盖 path（原子替换，不会留下写了一半的快照）
+    异常：文件无法创建或写入失败时抛出 GraphException（临时文件被删除，path 保持原样）
+    */
+    static void write(const CsrGraph &G, const string &path, const string &metadata = "");
+};
+
+ostream &operator<<(ostream &f, const SnapshotInfo &i);
+
+#endif